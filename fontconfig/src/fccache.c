@@ -1194,6 +1194,81 @@ FcDirCacheLoadFile (const FcChar8 *cache_file, struct stat *file_stat)
     return cache;
 }
 
+typedef struct _FcDirCacheStale {
+    FcCache	*cache;		/* first, FcDirCacheProcess looks at it */
+    time_t	time;		/* when the cache file was written */
+} FcDirCacheStale;
+
+static FcBool
+FcDirCacheStaleHelper (FcConfig *config, int fd, struct stat *fd_stat, struct stat *dir_stat, struct timeval *latest_cache_mtime FC_UNUSED, void *closure)
+{
+    FcDirCacheStale *stale = closure;
+    FcCache	*cache;
+
+    if (stale->cache && fd_stat->st_mtime - stale->time <= 0)
+	return FcFalse;
+    if (fd_stat->st_size > INTPTR_MAX ||
+        fd_stat->st_size < (int) sizeof (FcCache))
+	return FcFalse;
+    cache = malloc (fd_stat->st_size);
+    if (!cache)
+	return FcFalse;
+    /*
+     * A cache that still matches the directory is only rescanned when
+     * asked to, in which case nothing should be taken from it.
+     */
+    if (read (fd, cache, fd_stat->st_size) != fd_stat->st_size ||
+	cache->magic != FC_CACHE_MAGIC_MMAP ||
+	cache->version < FC_CACHE_VERSION_NUMBER ||
+	cache->size != (intptr_t) fd_stat->st_size ||
+	!FcCacheOffsetsValid (cache) ||
+	FcCacheTimeValid (config, cache, dir_stat))
+    {
+	free (cache);
+	return FcFalse;
+    }
+    cache->magic = FC_CACHE_MAGIC_ALLOC;
+    if (stale->cache)
+	free (stale->cache);
+    stale->cache = cache;
+    stale->time = fd_stat->st_mtime;
+    return FcTrue;
+}
+
+/*
+ * Read the newest cache file for dir that no longer matches the
+ * directory, so the fonts of files which have not changed since it
+ * was written can be reused instead of queried again.  Caches older
+ * than the configuration are skipped as the scan rules may differ.
+ * The result is not shared with other users of the cache files and
+ * must be released with free().
+ */
+FcCache *
+FcDirCacheLoadStale (const FcChar8 *dir, FcConfig *config, time_t *cache_time)
+{
+    FcDirCacheStale stale = { NULL, 0 };
+    FcFileTime	config_time;
+
+    /* the result is the last helper's only, which may have rejected
+     * its file after an earlier one was kept */
+    FcDirCacheProcess (config, dir, FcDirCacheStaleHelper, &stale, NULL);
+    if (!stale.cache)
+	return NULL;
+
+    config_time = FcConfigModifiedTime (config);
+    if (strcmp ((const char *) FcCacheDir (stale.cache), (const char *) dir) != 0 ||
+	(config_time.set && config_time.time - stale.time >= 0))
+    {
+	free (stale.cache);
+	return NULL;
+    }
+    if (FcDebug () & FC_DBG_CACHE)
+	printf ("FcDirCacheLoadStale dir \"%s\" reusing cache written at %ld\n",
+		dir, (long) stale.time);
+    *cache_time = stale.time;
+    return stale.cache;
+}
+
 static int
 FcDirChecksum (struct stat *statb)
 {
@@ -255,6 +255,19 @@ FcConfigNewestFile (FcStrSet *files)
     return newest;
 }
 
+FcFileTime
+FcConfigModifiedTime (FcConfig *config)
+{
+    FcFileTime	config_time, config_dir_time;
+
+    config_time = FcConfigNewestFile (config->configFiles);
+    config_dir_time = FcConfigNewestFile (config->configDirs);
+    if (config_dir_time.set &&
+	(!config_time.set || config_dir_time.time - config_time.time > 0))
+	config_time = config_dir_time;
+    return config_time;
+}
+
 FcBool
 FcConfigUptoDate (FcConfig *config)
 {
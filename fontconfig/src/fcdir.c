@@ -27,6 +27,12 @@
 #ifdef HAVE_DIRENT_H
 #include <dirent.h>
 #endif
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+#if !defined(FC_NO_MT) && !defined(_WIN32) && defined(HAVE_PTHREAD)
+#include <pthread.h>
+#endif
 
 FcBool
 FcFileIsDir (const FcChar8 *file)
@@ -191,12 +197,366 @@ cmpstringp(const void *p1, const void *p2)
     return strcmp(* (char **) p1, * (char **) p2);
 }
 
-FcBool
-FcDirScanConfig (FcFontSet	*set,
-		 FcStrSet	*dirs,
-		 const FcChar8	*dir,
-		 FcBool		force, /* XXX unused */
-		 FcConfig	*config)
+/*
+ * Files are only trusted to be unchanged when both their times are
+ * clearly older than the cache, as some file systems only keep times
+ * to the nearest two seconds (see fc-cache).
+ */
+#define FC_SCAN_TIME_SLACK	2
+
+#define FC_SCAN_MAX_THREADS	16
+
+/* A font file of the directory being scanned */
+typedef struct _FcDirScanJob {
+    const FcChar8   *file;
+    FcFontSet	    *set;	/* fonts of this file, in query order */
+} FcDirScanJob;
+
+/* The files which have to be queried, shared by the scanning threads */
+typedef struct _FcDirScanQueue {
+    FcDirScanJob    **jobs;
+    int		    njobs;
+    fc_atomic_int_t next;
+    FcConfig	    *config;
+} FcDirScanQueue;
+
+/* A font of the previous cache of the directory */
+typedef struct _FcDirScanPrev {
+    const FcChar8   *file;
+    int		    id;		/* index in the cache font set */
+} FcDirScanPrev;
+
+static int
+FcDirScanPrevCmp (const void *p1, const void *p2)
+{
+    const FcDirScanPrev *a = p1, *b = p2;
+    int ret = strcmp ((const char *) a->file, (const char *) b->file);
+
+    return ret ? ret : a->id - b->id;
+}
+
+static double
+FcDirScanClock (void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+
+    QueryPerformanceFrequency (&freq);
+    QueryPerformanceCounter (&count);
+    return count.QuadPart * 1000.0 / freq.QuadPart;
+#else
+    struct timeval tv;
+
+    gettimeofday (&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+/*
+ * FC_SCAN_THREADS overrides the number of threads, which otherwise
+ * follows the number of processors.
+ */
+static int
+FcDirScanThreads (int njobs)
+{
+    const char	*env = getenv ("FC_SCAN_THREADS");
+    int		n = 1;
+
+    if (env)
+	n = atoi (env);
+    else
+    {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo (&info);
+	n = info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	n = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    /* keep the per-file debug output in order */
+    if (FcDebug () & (FC_DBG_SCAN | FC_DBG_SCANV))
+	n = 1;
+    if (n > FC_SCAN_MAX_THREADS)
+	n = FC_SCAN_MAX_THREADS;
+    if (n > njobs)
+	n = njobs;
+    return n < 1 ? 1 : n;
+}
+
+/*
+ * Each file gets its own FreeType library in FcFreeTypeQueryAll and
+ * its own font set, so the queries only share the configuration, which
+ * is not modified while scanning.
+ */
+static void
+FcDirScanWork (FcDirScanQueue *queue)
+{
+    int i;
+
+    while ((i = fc_atomic_int_add (queue->next, 1)) < queue->njobs)
+	FcFileScanFontConfig (queue->jobs[i]->set, queue->jobs[i]->file,
+			      queue->config);
+}
+
+#if !defined(FC_NO_MT) && defined(_WIN32)
+static DWORD WINAPI
+FcDirScanThread (LPVOID closure)
+{
+    FcDirScanWork (closure);
+    return 0;
+}
+#elif !defined(FC_NO_MT) && defined(HAVE_PTHREAD)
+static void *
+FcDirScanThread (void *closure)
+{
+    FcDirScanWork (closure);
+    return NULL;
+}
+#endif
+
+static int
+FcDirScanRun (FcDirScanQueue *queue)
+{
+    int nthreads = FcDirScanThreads (queue->njobs);
+    int started = 0;
+#if !defined(FC_NO_MT) && (defined(_WIN32) || defined(HAVE_PTHREAD))
+    int i;
+#endif
+#if !defined(FC_NO_MT) && defined(_WIN32)
+    HANDLE threads[FC_SCAN_MAX_THREADS];
+
+    while (started < nthreads - 1)
+    {
+	threads[started] = CreateThread (NULL, 0, FcDirScanThread, queue, 0, NULL);
+	if (!threads[started])
+	    break;
+	started++;
+    }
+#elif !defined(FC_NO_MT) && defined(HAVE_PTHREAD)
+    pthread_t threads[FC_SCAN_MAX_THREADS];
+
+    while (started < nthreads - 1)
+    {
+	if (pthread_create (&threads[started], NULL, FcDirScanThread, queue) != 0)
+	    break;
+	started++;
+    }
+#else
+    (void) nthreads;
+#endif
+
+    /* this thread takes jobs too, and does all of them if none started */
+    FcDirScanWork (queue);
+
+#if !defined(FC_NO_MT) && defined(_WIN32)
+    for (i = 0; i < started; i++)
+    {
+	WaitForSingleObject (threads[i], INFINITE);
+	CloseHandle (threads[i]);
+    }
+#elif !defined(FC_NO_MT) && defined(HAVE_PTHREAD)
+    for (i = 0; i < started; i++)
+	pthread_join (threads[i], NULL);
+#endif
+    /* the threads started plus this one */
+    return started + 1;
+}
+
+/*
+ * Returns the part of a path below the sysroot
+ */
+static const FcChar8 *
+FcDirScanStripSysroot (const FcChar8 *file, const FcChar8 *sysroot)
+{
+    size_t len;
+
+    if (!sysroot)
+	return file;
+    len = strlen ((const char *) sysroot);
+    if (strncmp ((const char *) file, (const char *) sysroot, len) != 0)
+	return file;
+    if (file[len] != '/')
+	len--;
+    else if (file[len+1] == '/')
+	len++;
+    return &file[len];
+}
+
+/*
+ * Copy the fonts the previous cache holds for file into set
+ */
+static FcBool
+FcDirScanReuse (FcFontSet	    *set,
+		FcCache		    *prev,
+		FcDirScanPrev	    *fonts,
+		int		    nfonts,
+		const FcChar8	    *file)
+{
+    FcFontSet	*prev_set = FcCacheSet (prev);
+    int		lo = 0, hi = nfonts, mid;
+    FcPattern	*font;
+
+    while (lo < hi)
+    {
+	mid = (lo + hi) / 2;
+	if (strcmp ((const char *) fonts[mid].file, (const char *) file) < 0)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    for (; lo < nfonts && !strcmp ((const char *) fonts[lo].file, (const char *) file); lo++)
+    {
+	font = FcPatternDuplicate (FcFontSetFont (prev_set, fonts[lo].id));
+	if (!font)
+	    return FcFalse;
+	if (!FcFontSetAdd (set, font))
+	{
+	    FcPatternDestroy (font);
+	    return FcFalse;
+	}
+    }
+    return set->nfont > 0;
+}
+
+/*
+ * Build the font patterns of the files of a directory.  The fonts of
+ * files that have not changed since the previous cache was written are
+ * copied from it, the other files are queried by a pool of threads.
+ * The fonts are added to set in file order whichever way they were
+ * found, so the result does not depend on the number of threads.
+ */
+static FcBool
+FcDirScanFonts (FcFontSet	*set,
+		FcStrSet	*dirs,
+		const FcChar8	*dir,
+		FcStrSet	*files,
+		FcConfig	*config,
+		FcCache		*prev,
+		time_t		prev_time)
+{
+    const FcChar8   *sysroot = FcConfigGetSysRoot (config);
+    FcDirScanJob    *jobs;
+    FcDirScanQueue  queue;
+    FcDirScanPrev   *prev_fonts = NULL;
+    FcFontSet	    *prev_set;
+    FcChar8	    *f;
+    struct stat	    statb;
+    int		    nprev = 0, nreused = 0, nthreads = 0;
+    int		    i, j;
+    double	    start = 0;
+    FcBool	    ret = FcFalse;
+
+    if (!files->num)
+	return FcTrue;
+    if (FcDebug () & FC_DBG_SCANTIME)
+	start = FcDirScanClock ();
+
+    jobs = calloc (files->num, sizeof (FcDirScanJob));
+    queue.jobs = malloc (files->num * sizeof (FcDirScanJob *));
+    if (!jobs || !queue.jobs)
+	goto bail;
+    queue.njobs = 0;
+    queue.next = 0;
+    queue.config = config;
+
+    if (prev)
+    {
+	prev_set = FcCacheSet (prev);
+	prev_fonts = malloc (prev_set->nfont * sizeof (FcDirScanPrev));
+	for (i = 0; prev_fonts && i < prev_set->nfont; i++)
+	{
+	    if (FcPatternObjectGetString (FcFontSetFont (prev_set, i),
+					  FC_FILE_OBJECT, 0, &f) != FcResultMatch)
+		continue;
+	    prev_fonts[nprev].file = f;
+	    prev_fonts[nprev].id = i;
+	    nprev++;
+	}
+	if (prev_fonts)
+	    qsort (prev_fonts, nprev, sizeof (FcDirScanPrev), FcDirScanPrevCmp);
+    }
+
+    for (i = 0; i < files->num; i++)
+    {
+	const FcChar8 *file = files->strs[i];
+
+	if (FcStat (file, &statb) != 0)
+	    continue;
+	if (S_ISDIR (statb.st_mode))
+	{
+	    FcFileScanConfig (NULL, dirs, file, config);
+	    continue;
+	}
+	jobs[i].file = file;
+	jobs[i].set = FcFontSetCreate ();
+	if (!jobs[i].set)
+	    goto bail;
+	if (prev_fonts && statb.st_mtime != 0 &&
+	    prev_time - statb.st_mtime > FC_SCAN_TIME_SLACK &&
+	    prev_time - statb.st_ctime > FC_SCAN_TIME_SLACK &&
+	    FcDirScanReuse (jobs[i].set, prev, prev_fonts, nprev,
+			    FcDirScanStripSysroot (file, sysroot)))
+	{
+	    nreused++;
+	    continue;
+	}
+	/* start over if only some of the fonts could be copied */
+	for (j = 0; j < jobs[i].set->nfont; j++)
+	    FcPatternDestroy (jobs[i].set->fonts[j]);
+	jobs[i].set->nfont = 0;
+	queue.jobs[queue.njobs++] = &jobs[i];
+    }
+
+    if (queue.njobs)
+	nthreads = FcDirScanRun (&queue);
+
+    ret = FcTrue;
+    for (i = 0; i < files->num; i++)
+    {
+	FcFontSet *s = jobs[i].set;
+
+	if (!s)
+	    continue;
+	for (j = 0; j < s->nfont; j++)
+	{
+	    if (!FcFontSetAdd (set, s->fonts[j]))
+	    {
+		FcPatternDestroy (s->fonts[j]);
+		ret = FcFalse;
+	    }
+	}
+	s->nfont = 0;
+    }
+
+    if (FcDebug () & FC_DBG_SCANTIME)
+	printf ("\tScanned dir %s: %d files, %d reused, %d queried by %d threads in %.1f ms\n",
+		dir, files->num, nreused, queue.njobs, nthreads,
+		FcDirScanClock () - start);
+
+bail:
+    if (jobs)
+    {
+	for (i = 0; i < files->num; i++)
+	    if (jobs[i].set)
+		FcFontSetDestroy (jobs[i].set);
+	free (jobs);
+    }
+    if (queue.jobs)
+	free (queue.jobs);
+    if (prev_fonts)
+	free (prev_fonts);
+    return ret;
+}
+
+static FcBool
+FcDirScanConfigReuse (FcFontSet		*set,
+		      FcStrSet		*dirs,
+		      const FcChar8	*dir,
+		      FcConfig		*config,
+		      FcCache		*prev,
+		      time_t		prev_time)
 {
     DIR			*d;
     struct dirent	*e;
@@ -207,9 +567,6 @@ FcDirScanConfig (FcFontSet	*set,
     FcBool		ret = FcTrue;
     int			i;
 
-    if (!force)
-	return FcFalse;
-
     if (!set && !dirs)
 	return FcTrue;
 
@@ -270,8 +627,16 @@ FcDirScanConfig (FcFontSet	*set,
     /*
      * Scan file files to build font patterns
      */
-    for (i = 0; i < files->num; i++)
-	FcFileScanConfig (set, dirs, files->strs[i], config);
+    if (set)
+    {
+	if (!FcDirScanFonts (set, dirs, s_dir, files, config, prev, prev_time))
+	    ret = FcFalse;
+    }
+    else
+    {
+	for (i = 0; i < files->num; i++)
+	    FcFileScanConfig (set, dirs, files->strs[i], config);
+    }
 
 bail2:
     FcStrSetDestroy (files);
@@ -286,6 +651,19 @@ bail:
     return ret;
 }
 
+FcBool
+FcDirScanConfig (FcFontSet	*set,
+		 FcStrSet	*dirs,
+		 const FcChar8	*dir,
+		 FcBool		force, /* XXX unused */
+		 FcConfig	*config)
+{
+    if (!force)
+	return FcFalse;
+
+    return FcDirScanConfigReuse (set, dirs, dir, config, NULL, 0);
+}
+
 FcBool
 FcDirScan (FcFontSet	    *set,
 	   FcStrSet	    *dirs,
@@ -317,7 +695,8 @@ FcDirCacheScan (const FcChar8 *dir, FcConfig *config)
 {
     FcStrSet		*dirs;
     FcFontSet		*set;
-    FcCache		*cache = NULL;
+    FcCache		*cache = NULL, *prev = NULL;
+    time_t		prev_time = 0;
     struct stat		dir_stat;
     const FcChar8	*sysroot = FcConfigGetSysRoot (config);
     FcChar8		*d;
@@ -348,10 +727,16 @@ FcDirCacheScan (const FcChar8 *dir, FcConfig *config)
     fd = FcDirCacheLock (dir, config);
 #endif
     /*
-     * Scan the dir
+     * Scan the dir, reusing what an out of date cache knows.  Windows
+     * has no change time (FcStat reports the last write time for both)
+     * and copies keep the write time of their source, so a replaced
+     * file could pass for unchanged there; rescan everything instead.
      */
+#ifndef _WIN32
+    prev = FcDirCacheLoadStale (dir, config, &prev_time);
+#endif
     /* Do not pass sysroot here. FcDirScanConfig() do take care of it */
-    if (!FcDirScanConfig (set, dirs, dir, FcTrue, config))
+    if (!FcDirScanConfigReuse (set, dirs, dir, config, prev, prev_time))
 	goto bail2;
 
     /*
@@ -373,6 +758,9 @@ FcDirCacheScan (const FcChar8 *dir, FcConfig *config)
     FcStrSetDestroy (dirs);
  bail1:
     FcFontSetDestroy (set);
+    /* the fonts copied from it may point at its charsets */
+    if (prev)
+	free (prev);
  bail:
     FcStrFree (d);
 
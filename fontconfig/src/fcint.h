@@ -108,6 +108,7 @@ extern pfnSHGetFolderPathA pSHGetFolderPathA;
 #define FC_DBG_CONFIG	1024
 #define FC_DBG_LANGSET	2048
 #define FC_DBG_MATCH2	4096
+#define FC_DBG_SCANTIME	8192
 
 #define _FC_ASSERT_STATIC1(_line, _cond) typedef int _static_assert_on_line_##_line##_failed[(_cond)?1:-1] FC_UNUSED
 #define _FC_ASSERT_STATIC0(_line, _cond) _FC_ASSERT_STATIC1 (_line, (_cond))
@@ -621,6 +622,9 @@ FcDirCacheRebuild (FcCache *cache, struct stat *dir_stat, FcStrSet *dirs);
 FcPrivate FcBool
 FcDirCacheWrite (FcCache *cache, FcConfig *config);
 
+FcPrivate FcCache *
+FcDirCacheLoadStale (const FcChar8 *dir, FcConfig *config, time_t *cache_time);
+
 FcPrivate FcBool
 FcDirCacheCreateTagFile (const FcChar8 *cache_dir);
 
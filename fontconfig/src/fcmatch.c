@@ -498,15 +498,68 @@ typedef struct
     double weak_value;
 } FamilyEntry;
 
+/* A pattern element with a matcher, see FcCompareBounded */
+typedef struct
+{
+    FcPatternElt    *elt;
+    const FcMatcher *match;
+    int		     first;	/* most significant priority it scores */
+    FcBool	     typed;	/* compare may fail with a type mismatch */
+} FcCompareElt;
+
 typedef struct
 {
     FcHashTable *family_hash;
+    FcCompareElt *elts;
+    int          nelts;
 } FcCompareData;
 
 static void
 FcCompareDataClear (FcCompareData *data)
 {
     FcHashTableDestroy (data->family_hash);
+    free (data->elts);
+}
+
+static int
+FcCompareEltCmp (const void *a, const void *b)
+{
+    const FcCompareElt *ea = a, *eb = b;
+
+    return ea->first - eb->first;
+}
+
+/* Lists the elements of the pattern that contribute to the score,
+ * most significant first.
+ */
+static void
+FcCompareDataInitElts (FcPattern     *pat,
+                       FcCompareData *data)
+{
+    FcPatternElt *elts = FcPatternElts (pat);
+    const FcMatcher *match;
+    int i;
+
+    data->nelts = 0;
+    data->elts = malloc (pat->num * sizeof (FcCompareElt));
+    if (!data->elts)
+        return;
+    for (i = 0; i < pat->num; i++)
+    {
+        match = FcObjectToMatcher (elts[i].object, FcFalse);
+        if (!match)
+            continue;
+        data->elts[data->nelts].elt = &elts[i];
+        data->elts[data->nelts].match = match;
+        data->elts[data->nelts].first = FC_MIN (match->strong, match->weak);
+        data->elts[data->nelts].typed = (match->compare == FcCompareNumber ||
+                                         match->compare == FcCompareBool ||
+                                         match->compare == FcCompareLang ||
+                                         match->compare == FcCompareRange ||
+                                         match->compare == FcCompareSize);
+        data->nelts++;
+    }
+    qsort (data->elts, data->nelts, sizeof (FcCompareElt), FcCompareEltCmp);
 }
 
 static void
@@ -554,6 +607,7 @@ FcCompareDataInit (FcPattern     *pat,
     }
 
     data->family_hash = table;
+    FcCompareDataInitElts (pat, data);
 }
 
 static FcBool
@@ -656,6 +710,103 @@ FcCompare (FcPattern	*pat,
     return FcTrue;
 }
 
+/*
+ * FcCompare fails when any element fails with a type mismatch, so once
+ * FcCompareBounded has rejected a font the elements from k on that can
+ * fail that way are still compared, without keeping their score.
+ */
+static FcBool
+FcCompareTypes (FcPattern     *fnt,
+		int	       k,
+		FcResult      *result,
+		FcCompareData *data)
+{
+    FcCompareElt    *e;
+    FcPatternElt    *elt;
+    double	    value[PRI_END] = { 0 };
+
+    for (; k < data->nelts; k++)
+    {
+	e = &data->elts[k];
+	if (!e->typed)
+	    continue;
+	elt = FcPatternObjectFindElt (fnt, e->elt->object);
+	if (elt && !FcCompareValueList (e->elt->object, e->match,
+					FcPatternEltValues(e->elt),
+					FcPatternEltValues(elt),
+					NULL, value, NULL, result))
+	    return FcFalse;
+    }
+    return FcTrue;
+}
+
+/*
+ * Each score priority is fed by a single pattern element, so scoring the
+ * elements most significant first lets the comparison with the best
+ * score so far be made as the score is built.  Returns FcFalse in
+ * *better as soon as the font is known to lose to bestscore, leaving the
+ * rest of the score unset; otherwise the full score is computed, exactly
+ * as FcCompare does.  Either way it fails exactly when FcCompare would.
+ */
+static FcBool
+FcCompareBounded (FcPattern	*pat,
+		  FcPattern	*fnt,
+		  double	*value,
+		  const double	*bestscore,
+		  FcBool	*better,
+		  FcResult	*result,
+		  FcCompareData *data)
+{
+    FcCompareElt    *e;
+    FcPatternElt    *elt;
+    int		    i, k, limit, checked = 0;
+    FcBool	    decided = FcFalse;
+
+    for (i = 0; i < PRI_END; i++)
+	value[i] = 0.0;
+
+    *better = FcTrue;
+    for (k = 0; k <= data->nelts; k++)
+    {
+	/* every priority before the next element's is final by now */
+	limit = k < data->nelts ? data->elts[k].first : PRI_END;
+	for (; !decided && checked < limit; checked++)
+	{
+	    if (value[checked] > bestscore[checked])
+	    {
+		*better = FcFalse;
+		return FcCompareTypes (fnt, k, result, data);
+	    }
+	    if (value[checked] < bestscore[checked])
+		decided = FcTrue;
+	}
+	if (k == data->nelts)
+	    break;
+
+	e = &data->elts[k];
+	elt = FcPatternObjectFindElt (fnt, e->elt->object);
+	if (!elt)
+	    continue;
+	if (e->elt->object == FC_FAMILY_OBJECT && data->family_hash)
+	{
+	    if (!FcCompareFamilies (pat, FcPatternEltValues(e->elt),
+				    fnt, FcPatternEltValues(elt),
+				    value, result,
+				    data->family_hash))
+		return FcFalse;
+	}
+	else if (!FcCompareValueList (e->elt->object, e->match,
+				      FcPatternEltValues(e->elt),
+				      FcPatternEltValues(elt),
+				      NULL, value, NULL, result))
+	    return FcFalse;
+    }
+    /* a tie with the best score does not replace it */
+    if (!decided)
+	*better = FcFalse;
+    return FcTrue;
+}
+
 FcPattern *
 FcFontRenderPrepare (FcConfig	    *config,
 		     FcPattern	    *pat,
@@ -895,6 +1046,24 @@ FcFontSetMatchInternal (FcFontSet   **sets,
 		printf ("Font %d ", f);
 		FcPatternPrint (s->fonts[f]);
 	    }
+	    if (best && data.elts && !(FcDebug () & FC_DBG_MATCHV))
+	    {
+		FcBool better;
+
+		if (!FcCompareBounded (p, s->fonts[f], score, bestscore,
+				       &better, result, &data))
+		{
+		    FcCompareDataClear (&data);
+		    return 0;
+		}
+		if (better)
+		{
+		    for (i = 0; i < PRI_END; i++)
+			bestscore[i] = score[i];
+		    best = s->fonts[f];
+		}
+		continue;
+	    }
 	    if (!FcCompare (p, s->fonts[f], score, result, &data))
             {
                 FcCompareDataClear (&data);
@@ -0,0 +1,342 @@
+/*
+ * fontconfig/test/test-match-pruning.c
+ *
+ * Copyright © 2026 The fontconfig authors
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the author(s) not be used in
+ * advertising or publicity pertaining to distribution of the software without
+ * specific, written prior permission.  The authors make no
+ * representations about the suitability of this software for any purpose.  It
+ * is provided "as is" without express or implied warranty.
+ *
+ * THE AUTHOR(S) DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE AUTHOR(S) BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * FcFontSetMatch stops scoring a font once it is known to lose to the
+ * best one so far, except when match-verbose debugging is on.  Matches
+ * against a synthetic font set must come out the same either way.
+ *
+ * Run with a font count (e.g. "test-match-pruning 5000") to time
+ * FcFontSetMatch and FcFontSetSort on a set of that size instead.  The
+ * unpruned path is not timed, its debugging output would dominate.
+ */
+#include "fcint.h"
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char *families[] = {
+    "Alpha", "Beta", "Gamma Sans", "GammaSans", "gamma sans",
+    "Delta Serif", "Delta Mono", "Epsilon",
+};
+#define NUM_FAMILIES (sizeof (families) / sizeof (families[0]))
+
+static const char *styles[] = {
+    "Regular", "Bold", "Italic", "Bold Italic", "Light",
+};
+#define NUM_STYLES (sizeof (styles) / sizeof (styles[0]))
+
+static const char *langs[] = { "en", "fr", "de", "ja", "en-us" };
+#define NUM_LANGS (sizeof (langs) / sizeof (langs[0]))
+
+static const int weights[] = {
+    FC_WEIGHT_LIGHT, FC_WEIGHT_REGULAR, FC_WEIGHT_MEDIUM, FC_WEIGHT_BOLD,
+};
+#define NUM_WEIGHTS (sizeof (weights) / sizeof (weights[0]))
+
+static const int slants[] = {
+    FC_SLANT_ROMAN, FC_SLANT_ITALIC, FC_SLANT_OBLIQUE,
+};
+#define NUM_SLANTS (sizeof (slants) / sizeof (slants[0]))
+
+static unsigned int seed = 1;
+
+static unsigned int
+Random (unsigned int n)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % n;
+}
+
+static FcFontSet *
+BuildFontSet (int nfont)
+{
+    FcFontSet *set = FcFontSetCreate ();
+    char file[32];
+    int i;
+
+    for (i = 0; i < nfont; i++)
+    {
+	FcPattern *font = FcPatternCreate ();
+
+	FcPatternAddString (font, FC_FAMILY,
+			    (const FcChar8 *) families[Random (NUM_FAMILIES)]);
+	if (Random (4) == 0)
+	    FcPatternAddString (font, FC_FAMILY,
+				(const FcChar8 *) families[Random (NUM_FAMILIES)]);
+	FcPatternAddString (font, FC_STYLE,
+			    (const FcChar8 *) styles[Random (NUM_STYLES)]);
+	FcPatternAddInteger (font, FC_WEIGHT, weights[Random (NUM_WEIGHTS)]);
+	FcPatternAddInteger (font, FC_SLANT, slants[Random (NUM_SLANTS)]);
+	if (Random (2))
+	    FcPatternAddString (font, FC_LANG,
+				(const FcChar8 *) langs[Random (NUM_LANGS)]);
+	FcPatternAddBool (font, FC_SCALABLE, Random (2));
+	sprintf (file, "font%d", i);
+	FcPatternAddString (font, FC_FILE, (const FcChar8 *) file);
+	FcFontSetAdd (set, font);
+
+	/* the same font again, which ties with it */
+	if (Random (3) == 0)
+	{
+	    font = FcPatternDuplicate (font);
+	    FcPatternDel (font, FC_FILE);
+	    sprintf (file, "font%d-copy", i);
+	    FcPatternAddString (font, FC_FILE, (const FcChar8 *) file);
+	    FcFontSetAdd (set, font);
+	}
+    }
+    return set;
+}
+
+static FcPattern *
+BuildPattern (void)
+{
+    FcPattern *pat = FcPatternCreate ();
+    FcValue v;
+    int i, n;
+
+    /* a mix of strong and weak families, some not in the set at all */
+    n = Random (4);
+    for (i = 0; i < n; i++)
+    {
+	v.type = FcTypeString;
+	v.u.s = (const FcChar8 *) (Random (5) ? families[Random (NUM_FAMILIES)]
+						: "Unknown");
+	if (Random (2))
+	    FcPatternAddWeak (pat, FC_FAMILY, v, FcTrue);
+	else
+	    FcPatternAdd (pat, FC_FAMILY, v, FcTrue);
+    }
+    if (Random (2))
+	FcPatternAddString (pat, FC_STYLE,
+			    (const FcChar8 *) styles[Random (NUM_STYLES)]);
+    if (Random (2))
+	FcPatternAddInteger (pat, FC_WEIGHT, weights[Random (NUM_WEIGHTS)]);
+    if (Random (2))
+	FcPatternAddInteger (pat, FC_SLANT, slants[Random (NUM_SLANTS)]);
+    if (Random (2))
+	FcPatternAddString (pat, FC_LANG,
+			    (const FcChar8 *) langs[Random (NUM_LANGS)]);
+    if (Random (2))
+	FcPatternAddBool (pat, FC_SCALABLE, Random (2));
+    return pat;
+}
+
+/*
+ * Match verbosely, which disables pruning, with the debugging output
+ * thrown away.
+ */
+static FcPattern *
+MatchUnpruned (FcConfig *config, FcFontSet *set, FcPattern *pat,
+	       FcResult *result)
+{
+    FcFontSet *sets[1] = { set };
+    FcPattern *match;
+    int null, out;
+
+    fflush (stdout);
+    out = dup (1);
+    null = open ("/dev/null", O_WRONLY);
+    dup2 (null, 1);
+    close (null);
+
+    FcDebugVal = FC_DBG_MATCHV;
+    match = FcFontSetMatch (config, sets, 1, pat, result);
+    FcDebugVal = 0;
+
+    fflush (stdout);
+    dup2 (out, 1);
+    close (out);
+    return match;
+}
+
+static FcPattern *
+MatchPruned (FcConfig *config, FcFontSet *set, FcPattern *pat,
+	     FcResult *result)
+{
+    FcFontSet *sets[1] = { set };
+
+    return FcFontSetMatch (config, sets, 1, pat, result);
+}
+
+static int
+CompareMatches (FcConfig *config, FcFontSet *set, FcPattern *pat)
+{
+    FcPattern *pruned, *unpruned;
+    FcResult r1 = FcResultMatch, r2 = FcResultMatch;
+    FcChar8 *f1 = NULL, *f2 = NULL;
+    int ret = 0;
+
+    pruned = MatchPruned (config, set, pat, &r1);
+    unpruned = MatchUnpruned (config, set, pat, &r2);
+    if (pruned)
+	FcPatternGetString (pruned, FC_FILE, 0, &f1);
+    if (unpruned)
+	FcPatternGetString (unpruned, FC_FILE, 0, &f2);
+    if (!pruned != !unpruned || (!pruned && r1 != r2) ||
+	(f1 && f2 && strcmp ((const char *) f1, (const char *) f2) != 0))
+    {
+	printf ("Matching differs with pruning: %s (%d) vs. %s (%d) for\n",
+		f1 ? (const char *) f1 : "none", r1,
+		f2 ? (const char *) f2 : "none", r2);
+	FcPatternPrint (pat);
+	ret = 1;
+    }
+    if (pruned)
+	FcPatternDestroy (pruned);
+    if (unpruned)
+	FcPatternDestroy (unpruned);
+    return ret;
+}
+
+/*
+ * A font that loses on the family before its weight is scored must
+ * still fail the match when its weight has the wrong type.
+ */
+static int
+TestTypeMismatch (FcConfig *config)
+{
+    FcFontSet *set = FcFontSetCreate ();
+    FcPattern *pat, *match;
+    FcPatternElt *e;
+    FcResult result = FcResultMatch;
+    int ret = 0;
+
+    FcFontSetAdd (set, FcPatternBuild (NULL,
+				       FC_FAMILY, FcTypeString, "Alpha",
+				       FC_WEIGHT, FcTypeInteger, FC_WEIGHT_REGULAR,
+				       FC_FILE, FcTypeString, "good",
+				       NULL));
+    FcFontSetAdd (set, FcPatternBuild (NULL,
+				       FC_FAMILY, FcTypeString, "Beta",
+				       FC_WEIGHT, FcTypeInteger, FC_WEIGHT_REGULAR,
+				       FC_FILE, FcTypeString, "bad",
+				       NULL));
+    /* FcPatternAdd refuses a value of the wrong type */
+    e = FcPatternObjectFindElt (set->fonts[1], FC_WEIGHT_OBJECT);
+    e->values->value.type = FcTypeBool;
+    e->values->value.u.b = FcTrue;
+
+    pat = FcPatternBuild (NULL,
+			  FC_FAMILY, FcTypeString, "Alpha",
+			  FC_WEIGHT, FcTypeInteger, FC_WEIGHT_REGULAR,
+			  NULL);
+
+    match = MatchPruned (config, set, pat, &result);
+    if (match || result != FcResultTypeMismatch)
+    {
+	printf ("Type mismatch in a pruned font was not reported\n");
+	ret = 1;
+    }
+    if (match)
+	FcPatternDestroy (match);
+    ret |= CompareMatches (config, set, pat);
+
+    FcPatternDestroy (pat);
+    FcFontSetDestroy (set);
+    return ret;
+}
+
+static double
+Elapsed (clock_t start)
+{
+    return (double) (clock () - start) / CLOCKS_PER_SEC;
+}
+
+static void
+Benchmark (FcConfig *config, int nfont)
+{
+    FcFontSet *set = BuildFontSet (nfont);
+    FcFontSet *sets[1] = { set };
+    FcPattern *pats[100];
+    FcCharSet *csp;
+    FcFontSet *sorted;
+    FcPattern *match;
+    FcResult result;
+    clock_t start;
+    int npat = sizeof (pats) / sizeof (pats[0]);
+    int i;
+
+    for (i = 0; i < npat; i++)
+	pats[i] = BuildPattern ();
+
+    printf ("%d fonts, %d patterns\n", set->nfont, npat);
+
+    start = clock ();
+    for (i = 0; i < npat; i++)
+	if ((match = MatchPruned (config, set, pats[i], &result)))
+	    FcPatternDestroy (match);
+    printf ("FcFontSetMatch: %g ms per match\n", Elapsed (start) * 1000 / npat);
+
+    start = clock ();
+    for (i = 0; i < npat; i++)
+    {
+	csp = NULL;
+	if ((sorted = FcFontSetSort (config, sets, 1, pats[i], FcTrue, &csp,
+				     &result)))
+	    FcFontSetDestroy (sorted);
+	if (csp)
+	    FcCharSetDestroy (csp);
+    }
+    printf ("FcFontSetSort: %g ms per sort\n", Elapsed (start) * 1000 / npat);
+
+    for (i = 0; i < npat; i++)
+	FcPatternDestroy (pats[i]);
+    FcFontSetDestroy (set);
+}
+
+int
+main (int argc, char **argv)
+{
+    FcConfig *config;
+    FcFontSet *set;
+    FcPattern *pat;
+    int i, ret = 0;
+
+    /* an empty configuration, so FcFontRenderPrepare edits nothing */
+    config = FcConfigCreate ();
+    FcDebugVal = 0;
+
+    if (argc > 1)
+    {
+	Benchmark (config, atoi (argv[1]));
+	FcConfigDestroy (config);
+	return 0;
+    }
+
+    set = BuildFontSet (300);
+    for (i = 0; i < 1000; i++)
+    {
+	pat = BuildPattern ();
+	ret |= CompareMatches (config, set, pat);
+	FcPatternDestroy (pat);
+    }
+    FcFontSetDestroy (set);
+
+    ret |= TestTypeMismatch (config);
+
+    FcConfigDestroy (config);
+    return ret;
+}
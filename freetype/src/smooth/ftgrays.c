@@ -496,6 +496,7 @@ typedef ptrdiff_t  FT_PtrDist;
     TCoord  count_ey;        /* same as (max_ey - min_ey) */
 
     PCell       cell;        /* current cell                             */
+    TCoord      cell_ey;     /* its row index in `ycells'                */
     PCell       cell_free;   /* call allocation next free slot           */
     PCell       cell_null;   /* last cell, used as dumpster and limit    */
 
@@ -597,6 +598,13 @@ typedef ptrdiff_t  FT_PtrDist;
 
       ex = FT_MAX( ex, ras.min_ex - 1 );
 
+      /* Lines mostly step to the next cell on the right, which can be  */
+      /* found from the current cell since the list is sorted.  The     */
+      /* null cell, current at the start of each band, never satisfies  */
+      /* the test as it has the largest `x`.                            */
+      if ( ras.cell->x < ex && ey_index == ras.cell_ey )
+        pcell = &ras.cell->next;
+
       while ( 1 )
       {
         cell = *pcell;
@@ -623,7 +631,8 @@ typedef ptrdiff_t  FT_PtrDist;
       *pcell      = cell;
 
     Found:
-      ras.cell = cell;
+      ras.cell    = cell;
+      ras.cell_ey = ey_index;
     }
   }
 
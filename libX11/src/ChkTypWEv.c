@@ -28,6 +28,7 @@ in this Software without prior written authorization from The Open Group.
 #include <config.h>
 #endif
 #include "Xlibint.h"
+#include "Xxcbint.h"
 
 /*
  * Check existing events in queue to find if any match.  If so, return.
@@ -52,6 +53,9 @@ Bool XCheckTypedWindowEvent (
 
 	prev = NULL;
 	for (n = 3; --n >= 0;) {
+	    if (!_XQueuedTypeCount(dpy, type))
+		/* nothing of this type queued, skip to the new arrivals */
+		prev = (_XQEvent *) dpy->tail;
 	    for (qelt = prev ? prev->next : dpy->head;
 		 qelt;
 		 prev = qelt, qelt = qelt->next) {
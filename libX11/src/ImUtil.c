@@ -30,6 +30,7 @@ in this Software without prior written authorization from The Open Group.
 #include <X11/Xlibint.h>
 #include <X11/Xutil.h>
 #include <stdio.h>
+#include <string.h>
 #include <limits.h>
 #include "ImUtil.h"
 
@@ -824,6 +825,116 @@ static int _XPutPixel1 (
 	}
 }
 
+/*
+ * Whole-byte ZPixmap images whose pixels are read and written by the
+ * routines above can be copied a scanline at a time instead of through
+ * XGetPixel/XPutPixel.
+ */
+static int
+_XHasZPixelFuncs(
+    XImage *ximage)
+{
+	if (ximage->format != ZPixmap)
+	    return 0;
+	switch (ximage->bits_per_pixel) {
+	case 8:
+	case 16:
+	case 24:
+	case 32:
+	    break;
+	default:
+	    return 0;
+	}
+	return ((ximage->f.get_pixel == _XGetPixel ||
+		 ximage->f.get_pixel == _XGetPixel8 ||
+		 ximage->f.get_pixel == _XGetPixel16 ||
+		 ximage->f.get_pixel == _XGetPixel32) &&
+		(ximage->f.put_pixel == _XPutPixel ||
+		 ximage->f.put_pixel == _XPutPixel8 ||
+		 ximage->f.put_pixel == _XPutPixel16 ||
+		 ximage->f.put_pixel == _XPutPixel32));
+}
+
+/*
+ * Copies a width x height block of pixels from (sx, sy) in src to (dx, dy)
+ * in dst, with the same result as XGetPixel followed by XPutPixel: pixels
+ * are converted to the destination byte order and the bits above depth
+ * are cleared.  Returns 0, having done nothing, if the images are not
+ * suitable for this.
+ */
+static int
+_XCopyZScanlines(
+    XImage *src,
+    int sx,
+    int sy,
+    XImage *dst,
+    int dx,
+    int dy,
+    int width,
+    int height)
+{
+	int unit, row;
+	long nbytes, i;
+	unsigned long mask;
+	unsigned char m[4];
+	int swap;
+
+	if (!_XHasZPixelFuncs(src) || !_XHasZPixelFuncs(dst) ||
+	    (src->bits_per_pixel != dst->bits_per_pixel) ||
+	    (src->depth != dst->depth) ||
+	    (src->depth > src->bits_per_pixel))
+	    return 0;
+	unit = src->bits_per_pixel >> 3;
+	swap = (unit > 1) && (src->byte_order != dst->byte_order);
+	if (swap && (unit == 3))
+	    return 0;
+
+	/* the depth mask, laid out in the destination byte order */
+	mask = low_bits_table[src->depth];
+	for (i = 0; i < unit; i++) {
+	    int shift = (dst->byte_order == MSBFirst) ? (unit - 1 - i) << 3
+						      : i << 3;
+	    m[i] = mask >> shift;
+	}
+
+	nbytes = (long) width * unit;
+	for (row = 0; row < height; row++) {
+	    register unsigned char *sp = (unsigned char *) src->data +
+		(long) (sy + row) * src->bytes_per_line + (long) sx * unit;
+	    register unsigned char *dp = (unsigned char *) dst->data +
+		(long) (dy + row) * dst->bytes_per_line + (long) dx * unit;
+
+	    if (!swap)
+		memmove(dp, sp, nbytes);
+	    else if (unit == 2)
+		for (i = 0; i < nbytes; i += 2) {
+		    dp[i] = sp[i + 1];
+		    dp[i + 1] = sp[i];
+		}
+	    else
+		for (i = 0; i < nbytes; i += 4) {
+		    dp[i] = sp[i + 3];
+		    dp[i + 1] = sp[i + 2];
+		    dp[i + 2] = sp[i + 1];
+		    dp[i + 3] = sp[i];
+		}
+
+	    if (src->depth != src->bits_per_pixel) {
+		if (unit == 4)
+		    for (i = 0; i < nbytes; i += 4) {
+			dp[i] &= m[0];
+			dp[i + 1] &= m[1];
+			dp[i + 2] &= m[2];
+			dp[i + 3] &= m[3];
+		    }
+		else
+		    for (i = 0; i < nbytes; i++)
+			dp[i] &= m[i % unit];
+	    }
+	}
+	return 1;
+}
+
 /*
  * SubImage
  *
@@ -889,6 +1000,9 @@ static XImage *_XSubImage (
 	if (height > ximage->height - y ) height = ximage->height - y;
 	if (width > ximage->width - x ) width = ximage->width - x;
 
+	if (_XCopyZScanlines(ximage, x, y, subimage, 0, 0, width, height))
+	    return subimage;
+
 	for (row = y; row < (y + height); row++) {
 	    for (col = x; col < (x + width); col++) {
 		pixel = XGetPixel(ximage, col, row);
@@ -948,6 +1062,12 @@ int _XSetImage(
 	if (srcimg->height < height)
 	    height = srcimg->height;
 
+	if ((width > startcol) && (height > startrow) &&
+	    _XCopyZScanlines(srcimg, startcol, startrow, dstimg,
+			     x + startcol, y + startrow,
+			     width - startcol, height - startrow))
+	    return 1;
+
 	/* this is slow, will do better later */
 	for (row = startrow; row < height; row++) {
 	    for (col = startcol; col < width; col++) {
@@ -533,6 +533,8 @@ XOpenDisplay (
  * get the resource manager database off the root window.
  */
 	LockDisplay(dpy);
+	/* the replies arrive along with the one to GetProperty below */
+	_XPrefetchExtensions(dpy);
 	{
 	    xGetPropertyReply reply;
 	    xGetPropertyReq *req;
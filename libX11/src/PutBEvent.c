@@ -31,6 +31,7 @@ from The Open Group.
 #include <config.h>
 #endif
 #include "Xlibint.h"
+#include "Xxcbint.h"
 
 int
 _XPutBackEvent (
@@ -70,6 +71,7 @@ _XPutBackEvent (
 	if (dpy->tail == NULL)
 	    dpy->tail = qelt;
 	dpy->qlen++;
+	_XQueuedTypeCount(dpy, qelt->event.type)++;
 	return 0;
 	}
 
@@ -34,6 +34,7 @@ in this Software without prior written authorization from The Open Group.
 #include "Cr.h"
 #include "ImUtil.h"
 #include "reallocarray.h"
+#include "Xxcbint.h"
 
 #if defined(__STDC__) && ((defined(sun) && defined(SVR4)) || defined(WIN32))
 #define RConst /**/
@@ -163,8 +164,6 @@ SwapTwoBytes (
     long length = ROUNDUP(srclen, 2);
     register long h, n;
 
-    srcinc -= length;
-    destinc -= length;
     for (h = height; --h >= 0; src += srcinc, dest += destinc) {
 	if ((h == 0) && (srclen != length)) {
 	    length -= 2;
@@ -173,9 +172,10 @@ SwapTwoBytes (
 	    else
 		*(dest + length + 1) = *(src + length);
 	}
-	for (n = length; n > 0; n -= 2, src += 2) {
-	    *dest++ = *(src + 1);
-	    *dest++ = *src;
+	/* indexed so that compilers can vectorize the scanline */
+	for (n = 0; n < length; n += 2) {
+	    dest[n] = src[n + 1];
+	    dest[n + 1] = src[n];
 	}
     }
 }
@@ -191,8 +191,6 @@ SwapThreeBytes (
     long length = ((srclen + 2) / 3) * 3;
     register long h, n;
 
-    srcinc -= length;
-    destinc -= length;
     for (h = height; --h >= 0; src += srcinc, dest += destinc) {
 	if ((h == 0) && (srclen != length)) {
 	    length -= 3;
@@ -203,10 +201,10 @@ SwapThreeBytes (
 	    else
 		*(dest + length + 2) = *(src + length);
 	}
-	for (n = length; n > 0; n -= 3, src += 3) {
-	    *dest++ = *(src + 2);
-	    *dest++ = *(src + 1);
-	    *dest++ = *src;
+	for (n = 0; n < length; n += 3) {
+	    dest[n] = src[n + 2];
+	    dest[n + 1] = src[n + 1];
+	    dest[n + 2] = src[n];
 	}
     }
 }
@@ -222,8 +220,6 @@ SwapFourBytes (
     long length = ROUNDUP(srclen, 4);
     register long h, n;
 
-    srcinc -= length;
-    destinc -= length;
     for (h = height; --h >= 0; src += srcinc, dest += destinc) {
 	if ((h == 0) && (srclen != length)) {
 	    length -= 4;
@@ -238,11 +234,11 @@ SwapFourBytes (
 	    if (half_order == LSBFirst)
 		*(dest + length + 3) = *(src + length);
 	}
-	for (n = length; n > 0; n -= 4, src += 4) {
-	    *dest++ = *(src + 3);
-	    *dest++ = *(src + 2);
-	    *dest++ = *(src + 1);
-	    *dest++ = *src;
+	for (n = 0; n < length; n += 4) {
+	    dest[n] = src[n + 3];
+	    dest[n + 1] = src[n + 2];
+	    dest[n + 2] = src[n + 1];
+	    dest[n + 3] = src[n];
 	}
     }
 }
@@ -746,6 +742,9 @@ SendXYImage(
 	_XSend(dpy, buf, length);
   }
 
+/* Shortest scanline SendZImage sends straight out of the image. */
+#define MIN_DIRECT_ROW_BYTES 1024
+
 static void
 SendZImage(
     register Display *dpy,
@@ -794,6 +793,20 @@ SendZImage(
 	return;
     }
 
+    /* Unswapped scanlines that are not contiguous in image->data (a
+     * sub-rectangle, or one touching the last scanline) are long enough
+     * to be worth handing to the transport in place rather than copying.
+     */
+    if (((image->byte_order == dpy->byte_order) ||
+	 (image->bits_per_pixel == 8)) &&
+	(bytes_per_src >= MIN_DIRECT_ROW_BYTES) &&
+	_XSendRows(dpy, (char *)src, bytes_per_src,
+		   (long)image->bytes_per_line, bytes_per_dest - bytes_per_src,
+		   req->height)) {
+	Xfree(shifted_src);
+	return;
+    }
+
     length = ROUNDUP(length, 4);
     if ((dpy->bufptr + length) <= dpy->bufmax)
 	dest = (unsigned char *)dpy->bufptr;
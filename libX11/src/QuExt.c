@@ -30,6 +30,197 @@ in this Software without prior written authorization from The Open Group.
 #include <limits.h>
 #include <stdbool.h>
 #include "Xlibint.h"
+#include "Xxcbint.h"
+
+/*
+ * The set of extensions cannot change for the life of a connection, so
+ * the answer to each QueryExtension is remembered per display.  Entries
+ * created by _XPrefetchExtensions are pending until their reply is seen
+ * by the async handler below.
+ */
+typedef struct _XExtCacheEntry {
+    struct _XExtCacheEntry *next;
+    char *name;
+    uint64_t sequence;		/* request sequence while pending, else 0 */
+    Bool present;
+    int major_opcode;
+    int first_event;
+    int first_error;
+} _XExtCacheEntry;
+
+struct _XExtCache {
+    _XAsyncHandler async;
+    int pending;
+    _XExtCacheEntry *entries;
+};
+
+/* Queried by most toolkits (and by Xlib itself for XKB) soon after startup. */
+static const char * const prefetch_names[] = {
+    "XKEYBOARD",
+    "RENDER",
+    "XInputExtension",
+    "XFIXES",
+    "SHAPE",
+    "RANDR",
+    "Generic Event Extension",
+    "MIT-SHM",
+    "Composite",
+    "DAMAGE",
+    "SYNC",
+    "XINERAMA",
+};
+
+static _XExtCacheEntry *
+_XLookupExtension(struct _XExtCache *cache, _Xconst char *name)
+{
+    _XExtCacheEntry *ext;
+
+    for (ext = cache->entries; ext; ext = ext->next)
+	if (!strcmp(ext->name, name))
+	    return ext;
+    return NULL;
+}
+
+static _XExtCacheEntry *
+_XAddExtension(struct _XExtCache *cache, _Xconst char *name)
+{
+    _XExtCacheEntry *ext;
+    size_t len = strlen(name);
+
+    ext = Xmalloc(sizeof(_XExtCacheEntry) + len + 1);
+    if (!ext)
+	return NULL;
+    ext->name = (char *) (ext + 1);
+    memcpy(ext->name, name, len + 1);
+    ext->sequence = 0;
+    ext->present = False;
+    ext->major_opcode = ext->first_event = ext->first_error = 0;
+    ext->next = cache->entries;
+    cache->entries = ext;
+    return ext;
+}
+
+static struct _XExtCache *
+_XGetExtensionCache(Display *dpy)
+{
+    struct _XExtCache *cache = dpy->xcb->ext_cache;
+
+    if (!cache) {
+	cache = Xcalloc(1, sizeof(struct _XExtCache));
+	dpy->xcb->ext_cache = cache;
+    }
+    return cache;
+}
+
+static void
+_XSetExtension(
+    _XExtCacheEntry *ext,
+    xQueryExtensionReply *rep)
+{
+    ext->sequence = 0;
+    ext->present = rep->present;
+    ext->major_opcode = rep->major_opcode;
+    ext->first_event = rep->first_event;
+    ext->first_error = rep->first_error;
+}
+
+static Bool
+_XExtCacheHandler(
+    register Display *dpy,
+    register xReply *rep,
+    char *buf,
+    int len,
+    XPointer data)
+{
+    struct _XExtCache *cache = (struct _XExtCache *) data;
+    xQueryExtensionReply replbuf;
+    xQueryExtensionReply *repl;
+    _XExtCacheEntry *ext;
+    uint64_t last_request_read = X_DPY_GET_LAST_REQUEST_READ(dpy);
+
+    for (ext = cache->entries; ext; ext = ext->next)
+	if (ext->sequence == last_request_read)
+	    break;
+    if (!ext)
+	return False;
+    if (rep->generic.type == X_Error) {
+	/* forget the entry so that XQueryExtension asks again */
+	ext->sequence = 0;
+	ext->name[0] = '\0';
+	repl = NULL;
+    } else {
+	repl = (xQueryExtensionReply *)
+	    _XGetAsyncReply(dpy, (char *)&replbuf, rep, buf, len,
+			    (SIZEOF(xQueryExtensionReply) - SIZEOF(xReply)) >> 2,
+			    True);
+	_XSetExtension(ext, repl);
+    }
+    if (--cache->pending == 0)
+	DeqAsyncHandler(dpy, &cache->async);
+    return repl != NULL;
+}
+
+static void
+_XSendQueryExtension(Display *dpy, _Xconst char *name)
+{
+    register xQueryExtensionReq *req;
+
+    GetReq(QueryExtension, req);
+    req->nbytes = name ? (CARD16) strlen(name) : 0;
+    req->length += (req->nbytes+(unsigned)3)>>2;
+    _XSend(dpy, name, (long)req->nbytes);
+}
+
+/*
+ * Send QueryExtension requests for commonly used extensions without
+ * waiting for the replies, so that the later XQueryExtension calls made
+ * by XInitExtension and friends do not each cost a round trip.  Must be
+ * called with the display locked.
+ */
+void
+_XPrefetchExtensions(Display *dpy)
+{
+    struct _XExtCache *cache = _XGetExtensionCache(dpy);
+    _XExtCacheEntry *ext;
+    size_t i;
+
+    if (!cache || cache->pending)
+	return;
+    for (i = 0; i < sizeof(prefetch_names) / sizeof(prefetch_names[0]); i++) {
+	if (_XLookupExtension(cache, prefetch_names[i]))
+	    continue;
+	ext = _XAddExtension(cache, prefetch_names[i]);
+	if (!ext)
+	    break;
+	_XSendQueryExtension(dpy, ext->name);
+	ext->sequence = X_DPY_GET_REQUEST(dpy);
+	cache->pending++;
+    }
+    if (cache->pending) {
+	cache->async.next = dpy->async_handlers;
+	cache->async.handler = _XExtCacheHandler;
+	cache->async.data = (XPointer) cache;
+	dpy->async_handlers = &cache->async;
+    }
+}
+
+void
+_XFreeExtensionCache(Display *dpy)
+{
+    struct _XExtCache *cache = dpy->xcb->ext_cache;
+    _XExtCacheEntry *ext;
+
+    if (!cache)
+	return;
+    if (cache->pending)
+	DeqAsyncHandler(dpy, &cache->async);
+    while ((ext = cache->entries)) {
+	cache->entries = ext->next;
+	Xfree(ext);
+    }
+    Xfree(cache);
+    dpy->xcb->ext_cache = NULL;
+}
 
 Bool
 XQueryExtension(
@@ -40,17 +231,39 @@ XQueryExtension(
     int *first_error)	/* RETURN */
 {
     xQueryExtensionReply rep;
-    register xQueryExtensionReq *req;
+    struct _XExtCache *cache = NULL;
+    _XExtCacheEntry *ext = NULL;
 
     if (name != NULL && strlen(name) >= USHRT_MAX)
         return false;
 
     LockDisplay(dpy);
-    GetReq(QueryExtension, req);
-    req->nbytes = name ? (CARD16) strlen(name) : 0;
-    req->length += (req->nbytes+(unsigned)3)>>2;
-    _XSend(dpy, name, (long)req->nbytes);
-    (void) _XReply (dpy, (xReply *)&rep, 0, xTrue);
+    if (name && *name) {
+	cache = _XGetExtensionCache(dpy);
+	if (cache)
+	    ext = _XLookupExtension(cache, name);
+    }
+    if (ext && !ext->sequence) {
+	*major_opcode = ext->major_opcode;
+	*first_event = ext->first_event;
+	*first_error = ext->first_error;
+	UnlockDisplay(dpy);
+	return ext->present;
+    }
+    /*
+     * A prefetched reply that is still outstanding will have been handled
+     * by the time the reply to this later request arrives.
+     */
+    _XSendQueryExtension(dpy, name);
+    if (!_XReply (dpy, (xReply *)&rep, 0, xTrue)) {
+	rep.present = xFalse;
+	rep.major_opcode = rep.first_event = rep.first_error = 0;
+    } else if (cache) {
+	if (!ext)
+	    ext = _XAddExtension(cache, name);
+	if (ext && !ext->sequence)
+	    _XSetExtension(ext, &rep);
+    }
     *major_opcode = rep.major_opcode;
     *first_event = rep.first_event;
     *first_error = rep.first_error;
@@ -58,4 +271,3 @@ XQueryExtension(
     SyncHandle();
     return (rep.present);
 }
-
@@ -40,6 +40,7 @@ from The Open Group.
 #endif
 #include "Xlibint.h"
 #include "Xprivate.h"
+#include "Xxcbint.h"
 #include "reallocarray.h"
 #include <X11/Xpoll.h>
 #include <assert.h>
@@ -788,6 +789,7 @@ void _XEnq(
 
 	    dpy->tail = qelt;
 	    dpy->qlen++;
+	    _XQueuedTypeCount(dpy, qelt->event.type)++;
 	} else if ((*dpy->event_vec[type])(dpy, &qelt->event, event)) {
 	    qelt->qserial_num = dpy->next_event_serial_num++;
 	    if (dpy->tail)	dpy->tail->next = qelt;
@@ -795,6 +797,7 @@ void _XEnq(
 
 	    dpy->tail = qelt;
 	    dpy->qlen++;
+	    _XQueuedTypeCount(dpy, qelt->event.type)++;
 	} else {
 	    /* ignored, or stashed away for many-to-one compression */
 	    qelt->next = dpy->qfree;
@@ -822,6 +825,11 @@ void _XDeq(
     qelt->next = dpy->qfree;
     dpy->qfree = qelt;
     dpy->qlen--;
+    if (_XQueuedTypeCount(dpy, qelt->event.type))
+	_XQueuedTypeCount(dpy, qelt->event.type)--;
+    if (dpy->qlen == 0)
+	/* resynchronize, in case a queued event was modified in place */
+	memset(dpy->xcb->queued_types, 0, sizeof(dpy->xcb->queued_types));
 
     if (_XIsEventCookie(dpy, &qelt->event)) {
 	XGenericEventCookie* cookie = &qelt->event.xcookie;
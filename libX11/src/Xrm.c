@@ -1100,6 +1100,16 @@ static void GetDatabase(
     char *lhs, lhs_s[DEF_BUFF_SIZE];
     XrmQuark quarks[QLIST_SIZE + 1];	/* allow for a terminal NullQuark */
     XrmBinding bindings[QLIST_SIZE + 1];
+    /*
+     * Resource files tend to repeat the leading components of one line on
+     * the next, so remember the text and quark last seen at each position
+     * and skip the quark table when they match.
+     */
+    _Xconst char *prev_name[QLIST_SIZE + 1];
+    int prev_len[QLIST_SIZE + 1];
+    Signature prev_sig[QLIST_SIZE + 1];
+    XrmQuark prev_quarks[QLIST_SIZE + 1];
+    int num_prev = 0;
 
     register char *ptr;
     register XrmBits bits = 0;
@@ -1109,7 +1119,7 @@ static void GetDatabase(
     register int num_quarks;
     register XrmBindingList t_bindings;
 
-    int len, alloc_chars;
+    int len, alloc_chars, qlen;
     unsigned long str_len;
     XrmValue value;
     Bool only_pcs;
@@ -1240,8 +1250,24 @@ static void GetDatabase(
 		    bits = next_char(c, str);
 		}
 
-		quarks[num_quarks++] =
-			_XrmInternalStringToQuark(lhs, ptr - lhs, sig, False);
+		/* the component is also contiguous in the input */
+		qlen = ptr - lhs;
+		if (num_quarks < num_prev &&
+		    prev_sig[num_quarks] == sig &&
+		    prev_len[num_quarks] == qlen &&
+		    !memcmp(prev_name[num_quarks], str - qlen, qlen)) {
+		    quarks[num_quarks] = prev_quarks[num_quarks];
+		} else {
+		    quarks[num_quarks] =
+			_XrmInternalStringToQuark(lhs, qlen, sig, False);
+		    prev_name[num_quarks] = str - qlen;
+		    prev_len[num_quarks] = qlen;
+		    prev_sig[num_quarks] = sig;
+		    prev_quarks[num_quarks] = quarks[num_quarks];
+		    if (num_quarks >= num_prev)
+			num_prev = num_quarks + 1;
+		}
+		num_quarks++;
 
 		if (num_quarks > QLIST_SIZE) {
 		    Xfree(rhs);
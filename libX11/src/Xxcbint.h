@@ -40,8 +40,17 @@ typedef struct _X11XCBPrivate {
 	xcondition_t event_notify;
 	int event_waiter;
 	xcondition_t reply_notify;
+
+	/* number of events of each type (modulo 128) in the event queue,
+	 * so that searches for a type that is not queued can be skipped */
+	unsigned int queued_types[128];
+
+	/* QueryExtension results, see QuExt.c */
+	struct _XExtCache *ext_cache;
 } _X11XCBPrivate;
 
+#define _XQueuedTypeCount(dpy,type) ((dpy)->xcb->queued_types[(type) & 0x7f])
+
 /* xcb_disp.c */
 
 int _XConnectXCB(Display *dpy, _Xconst char *display, int *screenp);
@@ -50,4 +59,15 @@ void _XFreeX11XCBStructure(Display *dpy);
 _X_HIDDEN
 unsigned long _XNextRequest(Display *dpy);
 
+/* xcb_io.c */
+
+_X_HIDDEN
+Bool _XSendRows(Display *dpy, const char *data, long rowlen, long stride,
+		long padlen, int rows);
+
+/* QuExt.c */
+
+_X_HIDDEN void _XPrefetchExtensions(Display *dpy);
+_X_HIDDEN void _XFreeExtensionCache(Display *dpy);
+
 #endif /* XXCBINT_H */
@@ -94,6 +94,7 @@ int _XConnectXCB(Display *dpy, _Xconst char *display, int *screenp)
 
 void _XFreeX11XCBStructure(Display *dpy)
 {
+	_XFreeExtensionCache(dpy);
 	/* reply_data was allocated by system malloc, not Xmalloc */
 	free(dpy->xcb->reply_data);
 	while(dpy->xcb->pending_requests)
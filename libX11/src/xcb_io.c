@@ -534,26 +534,16 @@ void _XReadEvents(Display *dpy)
 }
 
 /*
- * _XSend - Flush the buffer and send the client data. 32 bit word aligned
- * transmission is used, if size is not 0 mod 4, extra bytes are transmitted.
- *
- * Note that the connection must not be read from once the data currently
- * in the buffer has been written.
+ * Write the output buffer followed by the caller's vectors. vec[0] is
+ * reserved for the output buffer and is filled in here.
  */
-void _XSend(Display *dpy, const char *data, long size)
+static void send_vector(Display *dpy, struct iovec *vec, int count)
 {
 	static const xReq dummy_request;
-	static char const pad[3];
-	struct iovec vec[3];
 	uint64_t requests;
 	uint64_t dpy_request;
 	_XExtension *ext;
 	xcb_connection_t *c = dpy->xcb->connection;
-	if(dpy->flags & XlibDisplayIOError)
-		return;
-
-	if(dpy->bufptr == dpy->buffer && !size)
-		return;
 
 	/* append_pending_request does not alter the dpy request number
 	 * therefore we can get it outside of the loop and the if
@@ -574,20 +564,16 @@ void _XSend(Display *dpy, const char *data, long size)
 
 	vec[0].iov_base = dpy->buffer;
 	vec[0].iov_len = dpy->bufptr - dpy->buffer;
-	vec[1].iov_base = (char *)data;
-	vec[1].iov_len = size;
-	vec[2].iov_base = (char *)pad;
-	vec[2].iov_len = -size & 3;
 
 	for(ext = dpy->flushes; ext; ext = ext->next_flush)
 	{
 		int i;
-		for(i = 0; i < 3; ++i)
+		for(i = 0; i < count; ++i)
 			if(vec[i].iov_len)
 				ext->before_flush(dpy, &ext->codes, vec[i].iov_base, vec[i].iov_len);
 	}
 
-	if(xcb_writev(c, vec, 3, requests) < 0) {
+	if(xcb_writev(c, vec, count, requests) < 0) {
 		_XIOError(dpy);
 		return;
 	}
@@ -600,6 +586,75 @@ void _XSend(Display *dpy, const char *data, long size)
 	_XSetSeqSyncFunction(dpy);
 }
 
+/*
+ * _XSend - Flush the buffer and send the client data. 32 bit word aligned
+ * transmission is used, if size is not 0 mod 4, extra bytes are transmitted.
+ *
+ * Note that the connection must not be read from once the data currently
+ * in the buffer has been written.
+ */
+void _XSend(Display *dpy, const char *data, long size)
+{
+	static char const pad[3];
+	struct iovec vec[3];
+	if(dpy->flags & XlibDisplayIOError)
+		return;
+
+	if(dpy->bufptr == dpy->buffer && !size)
+		return;
+
+	vec[1].iov_base = (char *)data;
+	vec[1].iov_len = size;
+	vec[2].iov_base = (char *)pad;
+	vec[2].iov_len = -size & 3;
+	send_vector(dpy, vec, 3);
+}
+
+/*
+ * _XSendRows - Like _XSend, but the data is "rows" rows of "rowlen" bytes
+ * each, "stride" bytes apart, and every row is followed by "padlen" zero
+ * bytes. The rows are handed to XCB directly instead of being gathered
+ * into a scratch buffer first. Returns False, having sent nothing, if
+ * the request cannot be handled this way; the caller then has to copy.
+ */
+Bool _XSendRows(Display *dpy, const char *data, long rowlen, long stride,
+		long padlen, int rows)
+{
+	static char const pad[8];
+	struct iovec *vec;
+	long size;
+	int count, i;
+
+	if(padlen < 0 || padlen > (long) sizeof(pad) || rows <= 0)
+		return False;
+	if(dpy->flags & XlibDisplayIOError)
+		return True;
+
+	count = 1 + (padlen ? 2 : 1) * rows + 1;
+	vec = Xmalloc(count * sizeof(struct iovec));
+	if(!vec)
+		return False;
+
+	count = 1;
+	for(i = 0; i < rows; ++i, data += stride)
+	{
+		vec[count].iov_base = (char *)data;
+		vec[count++].iov_len = rowlen;
+		if(padlen)
+		{
+			vec[count].iov_base = (char *)pad;
+			vec[count++].iov_len = padlen;
+		}
+	}
+	size = (rowlen + padlen) * rows;
+	vec[count].iov_base = (char *)pad;
+	vec[count++].iov_len = -size & 3;
+
+	send_vector(dpy, vec, count);
+	Xfree(vec);
+	return True;
+}
+
 /*
  * _XFlush - Flush the X request buffer.  If the buffer is empty, no
  * action is taken.
@@ -131,6 +131,8 @@ typedef struct _XLCdGenericPart {
     SegConv 		segment_conv;      /* UDC */
     Bool 		use_stdc_env;
     Bool 		force_convert_to_mb;
+    XPointer 		utf8_ascii_charset;	/* lcUTF8.c, charset list */
+    XPointer 		utf8_ascii_fontcharset;	/* lcUTF8.c, fontset list */
 } XLCdGenericPart;
 
 typedef struct _XLCdGenericRec {
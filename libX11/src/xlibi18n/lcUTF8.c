@@ -476,6 +476,43 @@ open_cstoutf8(
 
 /* from XlcNUtf8String to XlcNCharSet */
 
+static int charset_wctocs(Utf8Conv *, Utf8Conv *, XlcSide *, XlcConv,
+			  unsigned char *, ucs4_t, int);
+
+/*
+ * The slot before the NULL terminated list of preferred character sets
+ * holds the character set charset_wctocs() picks for every ASCII
+ * character, if that is one character set encoding ASCII unchanged on
+ * the GL side; the converters then copy ASCII text without a lookup.
+ * It is found once per XLCd, when the converters are registered.
+ */
+#define ascii_charset(preferred) ((preferred)[-1])
+
+static Utf8Conv
+find_ascii_charset(
+    Utf8Conv *preferred,
+    XlcConv conv)
+{
+    Utf8Conv ascii = NULL;
+    Utf8Conv chosen;
+    XlcSide side;
+    unsigned char buf[8];
+    ucs4_t wc;
+
+    for (wc = 0; wc < 0x80; wc++) {
+	chosen = NULL;
+	if (charset_wctocs(preferred, &chosen, &side, conv, buf, wc,
+			   sizeof(buf)) != 1 ||
+	    buf[0] != wc || side != XlcGL)
+	    return NULL;
+	if (ascii == NULL)
+	    ascii = chosen;
+	else if (ascii != chosen)
+	    return NULL;
+    }
+    return ascii;
+}
+
 static XlcConv
 create_tocs_conv(
     XLCd lcd,
@@ -500,10 +537,10 @@ create_tocs_conv(
 	charset_num = all_charsets_count-1;
 
     conv = Xmalloc(sizeof(XlcConvRec)
-			     + (charset_num + 1) * sizeof(Utf8Conv));
+			     + (charset_num + 2) * sizeof(Utf8Conv));
     if (conv == (XlcConv) NULL)
 	return (XlcConv) NULL;
-    preferred = (Utf8Conv *) ((char *) conv + sizeof(XlcConvRec));
+    preferred = (Utf8Conv *) ((char *) conv + sizeof(XlcConvRec)) + 1;
 
     /* Loop through all codesets mentioned in the locale. */
     charset_num = 0;
@@ -532,6 +569,8 @@ create_tocs_conv(
     conv->methods = methods;
     conv->state = (XPointer) preferred;
 
+    ascii_charset(preferred) = (Utf8Conv) XLC_GENERIC(lcd, utf8_ascii_charset);
+
     return conv;
 }
 
@@ -598,6 +637,7 @@ utf8tocs(
     int num_args)
 {
     Utf8Conv *preferred_charsets;
+    Utf8Conv ascii;
     XlcCharSet last_charset = NULL;
     unsigned char const *src;
     unsigned char const *srcend;
@@ -609,6 +649,7 @@ utf8tocs(
 	return 0;
 
     preferred_charsets = (Utf8Conv *) conv->state;
+    ascii = ascii_charset(preferred_charsets);
     src = (unsigned char const *) *from;
     srcend = src + *from_left;
     dst = (unsigned char *) *to;
@@ -622,22 +663,30 @@ utf8tocs(
 	int consumed;
 	int count;
 
-	consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
-	if (consumed == RET_TOOFEW(0))
-	    break;
-	if (consumed == RET_ILSEQ) {
-	    src++;
-	    unconv_num++;
-	    continue;
-	}
+	if (*src < 0x80 && ascii != NULL) {
+	    /* what charset_wctocs() would do, without the lookup */
+	    chosen_charset = ascii;
+	    chosen_side = XlcGL;
+	    *dst = *src;
+	    consumed = count = 1;
+	} else {
+	    consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
+	    if (consumed == RET_TOOFEW(0))
+		break;
+	    if (consumed == RET_ILSEQ) {
+		src++;
+		unconv_num++;
+		continue;
+	    }
 
-	count = charset_wctocs(preferred_charsets, &chosen_charset, &chosen_side, conv, dst, wc, dstend-dst);
-	if (count == RET_TOOSMALL)
-	    break;
-	if (count == RET_ILSEQ) {
-	    src += consumed;
-	    unconv_num++;
-	    continue;
+	    count = charset_wctocs(preferred_charsets, &chosen_charset, &chosen_side, conv, dst, wc, dstend-dst);
+	    if (count == RET_TOOSMALL)
+		break;
+	    if (count == RET_ILSEQ) {
+		src += consumed;
+		unconv_num++;
+		continue;
+	    }
 	}
 
 	if (last_charset == NULL) {
@@ -688,6 +737,20 @@ open_utf8tocs(
     return create_tocs_conv(from_lcd, &methods_utf8tocs);
 }
 
+/* Stores the ASCII character set of a converter in the slot its XLCd
+   keeps for it, for ascii_charset() of later converters. */
+static void
+init_ascii_charset(
+    XlcConv conv,
+    XPointer *slot)
+{
+    if (conv != (XlcConv) NULL) {
+	*slot = (XPointer)
+	    find_ascii_charset((Utf8Conv *) conv->state, conv);
+	close_tocs_converter(conv);
+    }
+}
+
 /* from XlcNUtf8String to XlcNChar */
 
 static int
@@ -701,6 +764,7 @@ utf8tocs1(
     int num_args)
 {
     Utf8Conv *preferred_charsets;
+    Utf8Conv ascii;
     XlcCharSet last_charset = NULL;
     unsigned char const *src;
     unsigned char const *srcend;
@@ -712,6 +776,7 @@ utf8tocs1(
 	return 0;
 
     preferred_charsets = (Utf8Conv *) conv->state;
+    ascii = ascii_charset(preferred_charsets);
     src = (unsigned char const *) *from;
     srcend = src + *from_left;
     dst = (unsigned char *) *to;
@@ -725,22 +790,30 @@ utf8tocs1(
 	int consumed;
 	int count;
 
-	consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
-	if (consumed == RET_TOOFEW(0))
-	    break;
-	if (consumed == RET_ILSEQ) {
-	    src++;
-	    unconv_num++;
-	    continue;
-	}
+	if (*src < 0x80 && ascii != NULL) {
+	    /* what charset_wctocs() would do, without the lookup */
+	    chosen_charset = ascii;
+	    chosen_side = XlcGL;
+	    *dst = *src;
+	    consumed = count = 1;
+	} else {
+	    consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
+	    if (consumed == RET_TOOFEW(0))
+		break;
+	    if (consumed == RET_ILSEQ) {
+		src++;
+		unconv_num++;
+		continue;
+	    }
 
-	count = charset_wctocs(preferred_charsets, &chosen_charset, &chosen_side, conv, dst, wc, dstend-dst);
-	if (count == RET_TOOSMALL)
-	    break;
-	if (count == RET_ILSEQ) {
-	    src += consumed;
-	    unconv_num++;
-	    continue;
+	    count = charset_wctocs(preferred_charsets, &chosen_charset, &chosen_side, conv, dst, wc, dstend-dst);
+	    if (count == RET_TOOSMALL)
+		break;
+	    if (count == RET_ILSEQ) {
+		src += consumed;
+		unconv_num++;
+		continue;
+	    }
 	}
 
 	last_charset = _XlcGetCharSetWithSide(chosen_charset->name, chosen_side);
@@ -818,6 +891,12 @@ utf8tostr(
 	ucs4_t wc;
 	int consumed;
 
+	if (*src < 0x80) {
+	    if (dst == dstend)
+		break;
+	    *dst++ = *src++;
+	    continue;
+	}
 	consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
 	if (consumed == RET_TOOFEW(0))
 	    break;
@@ -888,7 +967,15 @@ strtoutf8(
     dstend = dst + *to_left;
 
     while (src < srcend) {
-	int count = utf8_wctomb(NULL, dst, *src, dstend-dst);
+	int count;
+
+	if (*src < 0x80) {
+	    if (dst == dstend)
+		break;
+	    *dst++ = *src++;
+	    continue;
+	}
+	count = utf8_wctomb(NULL, dst, *src, dstend-dst);
 	if (count == RET_TOOSMALL)
 	    break;
 	dst += count;
@@ -1135,6 +1222,9 @@ _XlcAddUtf8Converters(
     _XlcSetConverter(lcd, XlcNUtf8String, lcd, XlcNString, open_utf8tostr);
     _XlcSetConverter(lcd, XlcNUcsChar,    lcd, XlcNChar, open_ucstocs1);
     _XlcSetConverter(lcd, XlcNUcsChar,    lcd, XlcNUtf8String, open_ucstoutf8);
+
+    init_ascii_charset(create_tocs_conv(lcd, &methods_utf8tocs),
+		       &XLC_GENERIC(lcd, utf8_ascii_charset));
 }
 
 /***************************************************************************/
@@ -1172,7 +1262,13 @@ utf8towcs(
 
     while (src < srcend && dst < dstend) {
 	ucs4_t wc;
-	int consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
+	int consumed;
+
+	if (*src < 0x80) {
+	    *dst++ = *src++;
+	    continue;
+	}
+	consumed = utf8_mbtowc(NULL, &wc, src, srcend-src);
 	if (consumed == RET_TOOFEW(0))
 	    break;
 	if (consumed == RET_ILSEQ) {
@@ -1238,7 +1334,15 @@ wcstoutf8(
     unconv_num = 0;
 
     while (src < srcend) {
-	int count = utf8_wctomb(NULL, dst, *src, dstend-dst);
+	int count;
+
+	if ((ucs4_t) *src < 0x80) {
+	    if (dst == dstend)
+		break;
+	    *dst++ = (unsigned char) *src++;
+	    continue;
+	}
+	count = utf8_wctomb(NULL, dst, *src, dstend-dst);
 	if (count == RET_TOOSMALL)
 	    break;
 	if (count == RET_ILSEQ) {
@@ -1733,10 +1837,10 @@ create_tofontcs_conv(
 	num += count;
     }
 
-    conv = Xmalloc(sizeof(XlcConvRec) + (num + 1) * sizeof(Utf8Conv));
+    conv = Xmalloc(sizeof(XlcConvRec) + (num + 2) * sizeof(Utf8Conv));
     if (conv == (XlcConv) NULL)
 	return (XlcConv) NULL;
-    preferred = (Utf8Conv *) ((char *) conv + sizeof(XlcConvRec));
+    preferred = (Utf8Conv *) ((char *) conv + sizeof(XlcConvRec)) + 1;
 
     /* Loop through all fontsets mentioned in the locale. */
     for (i = 0, num = 0;; i++) {
@@ -1781,6 +1885,9 @@ create_tofontcs_conv(
     conv->methods = methods;
     conv->state = (XPointer) preferred;
 
+    ascii_charset(preferred) =
+	(Utf8Conv) XLC_GENERIC(lcd, utf8_ascii_fontcharset);
+
     return conv;
 }
 
@@ -2348,6 +2455,11 @@ _XlcAddUtf8LocaleConverters(
     _XlcSetConverter(lcd, XlcNMultiByte, lcd, XlcNFontCharSet, open_utf8tofcs);
     _XlcSetConverter(lcd, XlcNWideChar, lcd, XlcNFontCharSet, open_wcstofcs);
     _XlcSetConverter(lcd, XlcNUtf8String, lcd, XlcNFontCharSet, open_utf8tofcs);
+
+    init_ascii_charset(create_tocs_conv(lcd, &methods_utf8tocs),
+		       &XLC_GENERIC(lcd, utf8_ascii_charset));
+    init_ascii_charset(create_tofontcs_conv(lcd, &methods_utf8tocs),
+		       &XLC_GENERIC(lcd, utf8_ascii_fontcharset));
 }
 
 void
@@ -100,6 +100,7 @@ typedef struct _FontTable {
     int		    size;
     FontEntryPtr    entries;
     Bool	    sorted;
+    struct _FontFieldIndex *fields;	/* private to fontdir.c */
 } FontTableRec;
 
 typedef struct _FontDirectory {
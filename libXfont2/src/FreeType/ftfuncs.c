@@ -254,6 +254,7 @@ FreeTypeFreeFace(FTFacePtr face)
         }
         MUMBLE("Closing face: %s\n", face->filename);
         FT_Done_Face(face->face);
+        free(face->hmtx);
         free(face->filename);
         free(face);
     }
@@ -836,8 +837,45 @@ ft_make_up_italic_bitmap( char *raster, int bpr, int ht, int shift,
  * parse the htmx field in TrueType font.
  */
 
+/*
+ * The very lazy metrics of a large font read the hmtx table for every
+ * glyph, so the table is read once and kept with the face instead of
+ * being fetched from the font file a few bytes at a time.
+ */
+static FT_Byte *
+tt_get_hmtx( FTFacePtr face, FT_ULong *length )
+{
+    FT_ULong len = 0;
+
+    if ( !face->hmtx_loaded ) {
+	face->hmtx_loaded = 1;
+	if ( !FT_Load_Sfnt_Table( face->face, TTAG_hmtx, 0, NULL, &len ) &&
+	     len > 0 && (face->hmtx = malloc( len )) != NULL ) {
+	    if ( FT_Load_Sfnt_Table( face->face, TTAG_hmtx, 0,
+				     face->hmtx, &len ) ) {
+		free( face->hmtx );
+		face->hmtx = NULL;
+	    }
+	    else
+		face->hmtx_length = len;
+	}
+    }
+    *length = face->hmtx_length;
+    return face->hmtx;
+}
+
+static FT_UShort
+tt_get_hmtx_ushort( FTFacePtr face, FT_Byte *hmtx, FT_ULong offset )
+{
+    if ( hmtx )
+	return (FT_UShort)( (hmtx[offset] << 8) | hmtx[offset + 1] );
+    return sfnt_get_ushort( face->face, TTAG_hmtx, offset );
+}
+
+#define  tt_get_hmtx_short(f,h,o)  ((FT_Short)tt_get_hmtx_ushort((f),(h),(o)))
+
 static void
-tt_get_metrics( FT_Face         face,
+tt_get_metrics( FTFacePtr       face,
 		FT_UInt         idx,
 		FT_UInt         num_hmetrics,
 		FT_Short*       bearing,
@@ -851,9 +889,12 @@ tt_get_metrics( FT_Face         face,
     FT_UInt  count  = num_hmetrics;
     FT_ULong length = 0;
     FT_ULong offset = 0;
-    FT_Error error;
+    FT_Error error = 0;
+    FT_Byte  *hmtx;
 
-    error = FT_Load_Sfnt_Table( face, TTAG_hmtx, 0, NULL, &length );
+    hmtx = tt_get_hmtx( face, &length );
+    if ( !hmtx )
+	error = FT_Load_Sfnt_Table( face->face, TTAG_hmtx, 0, NULL, &length );
 
     if ( count == 0 || error )
     {
@@ -870,8 +911,8 @@ tt_get_metrics( FT_Face         face,
 	}
 	else
 	{
-	    *advance = sfnt_get_ushort( face, TTAG_hmtx, offset );
-	    *bearing = sfnt_get_short ( face, TTAG_hmtx, offset+2 );
+	    *advance = tt_get_hmtx_ushort( face, hmtx, offset );
+	    *bearing = tt_get_hmtx_short ( face, hmtx, offset+2 );
 	}
     }
     else
@@ -884,19 +925,19 @@ tt_get_metrics( FT_Face         face,
 	}
 	else
 	{
-	    *advance = sfnt_get_ushort ( face, TTAG_hmtx, offset );
+	    *advance = tt_get_hmtx_ushort ( face, hmtx, offset );
 	    offset += 4 + 2 * ( idx - count );
 	    if ( offset + 2 > length)
 		*bearing = 0;
 	    else
-		*bearing = sfnt_get_short ( face, TTAG_hmtx, offset );
+		*bearing = tt_get_hmtx_short ( face, hmtx, offset );
     }
     }
 }
 
 static int
 ft_get_very_lazy_bbox( FT_UInt index,
-		       FT_Face face,
+		       FTFacePtr ftface,
 		       FT_Size size,
 		       FT_UInt num_hmetrics,
 		       double slant,
@@ -905,6 +946,8 @@ ft_get_very_lazy_bbox( FT_UInt index,
 		       FT_Long *horiAdvance,
 		       FT_Long *vertAdvance)
 {
+    FT_Face face = ftface->face;
+
     if ( FT_IS_SFNT( face ) ) {
 	FT_Size_Metrics *smetrics = &size->metrics;
 	FT_Short  leftBearing = 0;
@@ -912,7 +955,7 @@ ft_get_very_lazy_bbox( FT_UInt index,
 	FT_Vector p0, p1, p2, p3;
 
 	/* horizontal */
-	tt_get_metrics( face, index, num_hmetrics,
+	tt_get_metrics( ftface, index, num_hmetrics,
 		       &leftBearing, &advance );
 
 #if 0
@@ -1127,7 +1170,7 @@ FreeTypeRasteriseGlyph(unsigned idx, int flags, CharInfoPtr tgp,
 	    }
 	    if( bitmap_metrics == NULL ) {
 		if ( sbitchk_incomplete_but_exist==0 && (instance->ttcap.flags & TTCAP_IS_VERY_LAZY) ) {
-		    if( ft_get_very_lazy_bbox( idx, face->face, instance->size,
+		    if( ft_get_very_lazy_bbox( idx, face, instance->size,
 					       face->num_hmetrics,
 					       instance->ttcap.vl_slant,
 					       &instance->transformation.matrix,
@@ -1323,7 +1366,7 @@ FreeTypeRasteriseGlyph(unsigned idx, int flags, CharInfoPtr tgp,
     if( (instance->ttcap.flags & TTCAP_MONO_CENTER) && hasMetrics ) {
 	if( is_outline == 1 ){
 	    if( correct ){
-		if( ft_get_very_lazy_bbox( idx, face->face, instance->size,
+		if( ft_get_very_lazy_bbox( idx, face, instance->size,
 					   face->num_hmetrics,
 					   instance->ttcap.vl_slant,
 					   &instance->transformation.matrix,
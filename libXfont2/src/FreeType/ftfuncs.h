@@ -47,6 +47,9 @@ typedef struct _FTFace {
     FT_Face face;
     int bitmap;
     FT_UInt num_hmetrics;
+    FT_Byte *hmtx;              /* copy of the hmtx table, see tt_get_metrics */
+    FT_ULong hmtx_length;
+    int hmtx_loaded;
     struct _FTInstance *instances;
     struct _FTInstance *active_instance;
     struct _FTFace *next;       /* link to next face in bucket */
@@ -187,15 +187,33 @@ _fs_convert_lfwi_reply(FSFpePtr conn, FontInfoPtr pfi,
 
 #define GLYPH_UNDEFINED(loc) ENCODING_UNDEFINED(encoding + (loc))
 
+/*
+ * widens a run of columns within one row to the aligned 16-glyph blocks
+ * containing it.  Printable ASCII is wanted by nearly all text whatever
+ * the font's encoding, so a run touching it grows to cover all of it.
+ */
+static void
+fs_widen_range(unsigned long row, int *col1, int *col2)
+{
+    *col1 &= 0xf0;
+    *col2 = (*col2 & 0xf0) + 15;
+    if (row == 0 && *col1 <= 0x7f && *col2 >= 0x20)
+    {
+	if (*col1 > 0x20) *col1 = 0x20;
+	if (*col2 < 0x7f) *col2 = 0x7f;
+    }
+}
+
 /*
  * figures out what glyphs to request
  *
  * Includes logic to attempt to reduce number of round trips to the font
  * server:  when a glyph is requested, fs_build_range() requests a
- * 16-glyph range of glyphs that contains the requested glyph.  This is
- * predicated on the belief that using a glyph increases the chances
- * that nearby glyphs will be used: a good assumption for phonetic
- * alphabets, but a questionable one for ideographic/pictographic ones.
+ * 16-glyph range of glyphs that contains the requested glyph, or all of
+ * printable ASCII for a glyph within it.  This is predicated on the
+ * belief that using a glyph increases the chances that nearby glyphs
+ * will be used: a good assumption for phonetic alphabets, but a
+ * questionable one for ideographic/pictographic ones.
  */
 /* ARGSUSED */
 int
@@ -249,11 +267,11 @@ fs_build_range(FontPtr pfont, Bool range_flag, unsigned int count,
 		GLYPH_UNDEFINED(col - firstcol))
 	    {
 		int col1, col2;
-		col1 = col & 0xf0;
-		col2 = col1 + 15;
+		col1 = col2 = col;
+		fs_widen_range(0, &col1, &col2);
 		if (col1 < firstcol) col1 = firstcol;
 		if (col2 > lastcol) col2 = lastcol;
-		/* Collect a 16-glyph neighborhood containing the requested
+		/* Collect the neighborhood containing the requested
 		   glyph... should in most cases reduce the number of round
 		   trips to the font server. */
 		for (col = col1; col <= col2; col++)
@@ -286,6 +304,7 @@ fs_build_range(FontPtr pfont, Bool range_flag, unsigned int count,
 	while (count--)
 	{
 	    int row1, col1, row2, col2;
+	    Bool widened = FALSE;
 	    row1 = row2 = *data++;
 	    col1 = col2 = *data++;
 	    if (range_flag)
@@ -321,16 +340,14 @@ fs_build_range(FontPtr pfont, Bool range_flag, unsigned int count,
 		{
 		    if (GLYPH_UNDEFINED(loc))
 		    {
-			if (row1 == row2 &&
-			    (((col1 & 0xf) && col1 > firstcol) ||
-			     (col2 & 0xf) != 0xf) && (col2 < lastcol))
+			if (row1 == row2 && !widened)
 			{
 			    /* If we're loading from a single row, expand
 			       range of glyphs loaded to a multiple of
 			       a 16-glyph range -- attempt to reduce number
 			       of round trips to the font server. */
-			    col1 &= 0xf0;
-			    col2 = (col2 & 0xf0) + 15;
+			    widened = TRUE;
+			    fs_widen_range(row, &col1, &col2);
 			    if (col1 < firstcol) col1 = firstcol;
 			    if (col2 > lastcol) col2 = lastcol;
 			    goto expand_glyph_range;
@@ -702,6 +719,7 @@ fs_create_font (FontPathElementPtr  fpe,
     fsd->format = format;
     fsd->fmask = fmask;
     fsd->name = (char *) (fsd + 1);
+    fsd->namelen = namelen;
     memcpy (fsd->name, name, namelen);
     fsd->name[namelen] = '\0';
     fsd->fontid = GetNewFontClientID ();
@@ -731,5 +749,6 @@ fs_alloc_glyphs (FontPtr pFont, int size)
 	return NULL;
     glyphs->next = fsfont->glyphs;
     fsfont->glyphs = glyphs;
+    fsfont->glyphs_size += size;
     return (pointer) (glyphs + 1);
 }
@@ -132,6 +132,8 @@ static fsGenericReply *fs_get_reply (FSFpePtr conn, int *error);
 static int fs_await_reply (FSFpePtr conn);
 static void _fs_do_blocked (FSFpePtr conn);
 static void fs_cleanup_bfont (FSFpePtr conn, FSBlockedFontPtr bfont);
+static void fs_trim_closed_fonts (FSFpePtr conn, int nfonts,
+				  unsigned long nbytes);
 
 char _fs_glyph_undefined;
 char _fs_glyph_requested;
@@ -141,6 +143,15 @@ static int  generationCount;
 
 static int FontServerRequestTimeout = 30 * 1000;
 
+/*
+ * Fonts are kept for a while after their last user closes them, along
+ * with the glyphs fetched so far, so that opening one again costs no
+ * round trips to the font server.  The oldest ones are closed for real
+ * once either limit is exceeded.
+ */
+#define FS_CLOSED_FONTS		16
+#define FS_CLOSED_GLYPH_BYTES	(1024 * 1024)
+
 static void
 _fs_close_server (FSFpePtr conn);
 
@@ -360,6 +371,7 @@ fs_init_fpe(FontPathElementPtr fpe)
 static int
 fs_reset_fpe(FontPathElementPtr fpe)
 {
+    fs_trim_closed_fonts ((FSFpePtr) fpe->private, 0, 0);
     (void) _fs_send_init_packets((FSFpePtr) fpe->private);
     return Successful;
 }
@@ -382,6 +394,7 @@ fs_free_fpe(FontPathElementPtr fpe)
 	    break;
 	}
     }
+    fs_trim_closed_fonts (conn, 0, 0);
     _fs_unmark_block (conn, conn->blockState);
     fs_close_conn(conn);
     remove_fs_handlers2(fpe, fs_block_handler, fs_fpes == 0);
@@ -1620,6 +1633,40 @@ _fs_do_blocked (FSFpePtr conn)
     }
 }
 
+/*
+ * takes a font matching an open request off the list of closed ones,
+ * dropping any found to be from a previous connection on the way
+ */
+static FontPtr
+fs_find_closed_font(FSFpePtr conn, const char *name, int namelen,
+		    fsBitmapFormat format, fsBitmapFormatMask fmask)
+{
+    FontPtr	    pfont, *prev;
+    FSFontDataPtr   fsd;
+    FSFontPtr	    fsfont;
+
+    prev = &conn->closedFonts;
+    while ((pfont = *prev))
+    {
+	fsd = (FSFontDataPtr) pfont->fpePrivate;
+	fsfont = (FSFontPtr) pfont->fontPrivate;
+	if (fsd->generation == conn->generation &&
+	    (fsd->namelen != namelen || memcmp (fsd->name, name, namelen) ||
+	     fsd->format != format || fsd->fmask != fmask))
+	{
+	    prev = &fsd->closed_next;
+	    continue;
+	}
+	*prev = fsd->closed_next;
+	conn->numClosedFonts--;
+	conn->closedGlyphBytes -= fsfont->glyphs_size;
+	if (fsd->generation == conn->generation)
+	    return pfont;
+	(*pfont->unload_font) (pfont);
+    }
+    return NullFont;
+}
+
 /*
  * sends the actual request out
  */
@@ -1680,6 +1727,13 @@ fs_send_open_font(pointer client, FontPathElementPtr fpe, Mask flags,
     }
     else
     {
+	font = fs_find_closed_font (conn, name, namelen, format, fmask);
+	if (font)
+	{
+	    *ppfont = font;
+	    return Successful;
+	}
+
 	font = fs_create_font (fpe, name, namelen, format, fmask);
 	if (!font)
 	    return AllocError;
@@ -1872,15 +1926,70 @@ fs_send_close_font(FSFpePtr conn, Font id)
     return Successful;
 }
 
+static void
+_fs_close_font(FSFpePtr conn, FontPtr pfont)
+{
+    FSFontDataPtr   fsd = (FSFontDataPtr) pfont->fpePrivate;
+
+    if (conn->generation == fsd->generation)
+	fs_send_close_font(conn, fsd->fontid);
+    (*pfont->unload_font) (pfont);
+}
+
+/*
+ * closes the oldest of the closed fonts until no more than nfonts holding
+ * no more than nbytes of glyphs remain
+ */
+static void
+fs_trim_closed_fonts(FSFpePtr conn, int nfonts, unsigned long nbytes)
+{
+    FontPtr	    pfont, *prev;
+
+    while (conn->numClosedFonts > nfonts || conn->closedGlyphBytes > nbytes)
+    {
+	prev = &conn->closedFonts;
+	while (((FSFontDataPtr) (*prev)->fpePrivate)->closed_next)
+	    prev = &((FSFontDataPtr) (*prev)->fpePrivate)->closed_next;
+	pfont = *prev;
+	*prev = NullFont;
+	conn->numClosedFonts--;
+	conn->closedGlyphBytes -= ((FSFontPtr) pfont->fontPrivate)->glyphs_size;
+	_fs_close_font (conn, pfont);
+    }
+}
+
 /* ARGSUSED */
 static void
 fs_close_font(FontPathElementPtr fpe, FontPtr pfont)
 {
     FSFontDataPtr   fsd = (FSFontDataPtr) pfont->fpePrivate;
+    FSFontPtr	    fsfont = (FSFontPtr) pfont->fontPrivate;
     FSFpePtr	    conn = (FSFpePtr) fpe->private;
+    FSBlockDataPtr  blockrec;
 
-    if (conn->generation == fsd->generation)
-	fs_send_close_font(conn, fsd->fontid);
+    /*
+     * Keep the font unless it is gone from the server or still has
+     * replies on the way; both open and glyph block records start with
+     * the font they are for.
+     */
+    for (blockrec = conn->blockedRequests; blockrec; blockrec = blockrec->next)
+    {
+	if ((blockrec->type == FS_OPEN_FONT ||
+	     blockrec->type == FS_LOAD_GLYPHS) &&
+	    *(FontPtr *) blockrec->data == pfont)
+	    break;
+    }
+    if (!blockrec && conn->generation == fsd->generation &&
+	!(conn->blockState & FS_GIVE_UP) &&
+	fsfont->glyphs_size <= FS_CLOSED_GLYPH_BYTES)
+    {
+	fsd->closed_next = conn->closedFonts;
+	conn->closedFonts = pfont;
+	conn->numClosedFonts++;
+	conn->closedGlyphBytes += fsfont->glyphs_size;
+	fs_trim_closed_fonts (conn, FS_CLOSED_FONTS, FS_CLOSED_GLYPH_BYTES);
+	return;
+    }
 
 #ifdef DEBUG
     {
@@ -1898,7 +2007,7 @@ fs_close_font(FontPathElementPtr fpe, FontPtr pfont)
 	}
     }
 #endif
-    (*pfont->unload_font) (pfont);
+    _fs_close_font (conn, pfont);
 }
 
 static int
@@ -45,6 +45,7 @@ typedef struct _fs_font {
     CharInfoPtr encoding;
     CharInfoPtr inkMetrics;
     FSGlyphPtr	glyphs;
+    unsigned long glyphs_size;	/* bytes allocated for glyphs */
 }           FSFontRec, *FSFontPtr;
 
 /* FS special data for the font */
@@ -58,6 +59,8 @@ typedef struct _fs_font_data {
     char       *name;
     fsBitmapFormat	format;
     fsBitmapFormatMask	fmask;
+
+    FontPtr	closed_next;	/* next in the connection's closed fonts */
 }           FSFontDataRec;
 
 typedef struct fs_clients_depending {
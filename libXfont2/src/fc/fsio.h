@@ -116,6 +116,10 @@ typedef struct _fs_fpe_data {
 
     FSBlockDataPtr  blockedRequests;
 
+    FontPtr	closedFonts;		/* recently closed fonts, newest first */
+    int		numClosedFonts;
+    unsigned long closedGlyphBytes;	/* glyph storage held by closedFonts */
+
     struct _XtransConnInfo *trans_conn; /* transport connection object */
 }           FSFpeRec;
 
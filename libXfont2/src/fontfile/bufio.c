@@ -173,25 +173,56 @@ BufFileOpenWrite (int fd)
 int
 BufFileRead (BufFilePtr f, char *b, int n)
 {
-    int	    c, cnt;
+    int	    c, cnt, len;
     cnt = n;
-    while (cnt--) {
-	c = BufFileGet (f);
-	if (c == BUFFILEEOF)
-	    break;
-	*b++ = c;
+    while (cnt) {
+	if (f->left > 0) {
+	    /* copy out whatever is buffered in one go */
+	    len = f->left < cnt ? f->left : cnt;
+	    memcpy (b, f->bufp, len);
+	    f->bufp += len;
+	    f->left -= len;
+	    b += len;
+	    cnt -= len;
+	} else if (f->input == BufFileRawFill && cnt >= BUFFILESIZE) {
+	    /* large reads of plain files go straight to the caller */
+	    len = read (FileDes(f), b, cnt);
+	    if (len <= 0) {
+		f->eof = BUFFILEEOF;
+		break;
+	    }
+	    b += len;
+	    cnt -= len;
+	} else {
+	    c = BufFileGet (f);
+	    if (c == BUFFILEEOF)
+		break;
+	    *b++ = c;
+	    cnt--;
+	}
     }
-    return n - cnt - 1;
+    return n - cnt;
 }
 
 int
 BufFileWrite (BufFilePtr f, const char *b, int n)
 {
-    int	    cnt;
+    int	    cnt, len;
     cnt = n;
-    while (cnt--) {
-	if (BufFilePut (*b++, f) == BUFFILEEOF)
-	    return BUFFILEEOF;
+    while (cnt) {
+	if (f->left > 1) {
+	    /* BufFilePut flushes when the last byte of room is used */
+	    len = f->left - 1 < cnt ? f->left - 1 : cnt;
+	    memcpy (f->bufp, b, len);
+	    f->bufp += len;
+	    f->left -= len;
+	    b += len;
+	    cnt -= len;
+	} else {
+	    if (BufFilePut (*b++, f) == BUFFILEEOF)
+		return BUFFILEEOF;
+	    cnt--;
+	}
     }
     return n;
 }
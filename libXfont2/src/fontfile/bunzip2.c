@@ -35,11 +35,14 @@
 #include <X11/fonts/bufio.h>
 #include <bzlib.h>
 
+/* decompress in chunks much larger than a BufFile's own buffer */
+#define ZIPBUFSIZE	(64 * 1024)
+
 typedef struct _xzip_buf {
     bz_stream z;
     int zstat;
-    BufChar b[BUFFILESIZE];
-    BufChar b_in[BUFFILESIZE];
+    BufChar b[ZIPBUFSIZE];
+    BufChar b_in[ZIPBUFSIZE];
     BufFilePtr f;
 } xzip_buf;
 
@@ -68,7 +71,7 @@ BufFilePushBZIP2 (BufFilePtr f)
 
     /* now that the history buffer is allocated, we provide the data buffer */
     x->z.next_out = (char *) x->b;
-    x->z.avail_out = BUFFILESIZE;
+    x->z.avail_out = ZIPBUFSIZE;
     x->z.next_in = (char *) x->b_in;
     x->z.avail_in = 0;
 
@@ -123,19 +126,14 @@ BufBzip2FileFill (BufFilePtr f)
     /* now we work to consume what we can */
     /* let libbz2 know what we can handle */
     x->z.next_out = (char *) x->b;
-    x->z.avail_out = BUFFILESIZE;
+    x->z.avail_out = ZIPBUFSIZE;
 
     /* and try to consume all of it */
     while (x->z.avail_out > 0) {
 	/* if we don't have anything to work from... */
 	if (x->z.avail_in == 0) {
 	    /* ... fill the z buf from underlying file */
-	    int i, c;
-	    for (i = 0; i < sizeof(x->b_in); i++) {
-		c = BufFileGet(x->f);
-		if (c == BUFFILEEOF) break;
-		x->b_in[i] = c;
-	    }
+	    int i = BufFileRead(x->f, (char *) x->b_in, sizeof(x->b_in));
 	    x->z.avail_in += i;
 	    x->z.next_in = (char *) x->b_in;
 	}
@@ -151,7 +149,7 @@ BufBzip2FileFill (BufFilePtr f)
 	}
     }
     f->bufp = x->b;
-    f->left = BUFFILESIZE - x->z.avail_out;
+    f->left = ZIPBUFSIZE - x->z.avail_out;
 
     if (f->left >= 0) {
 	f->left--;
@@ -169,9 +167,17 @@ BufBzip2FileSkip (BufFilePtr f, int c)
        BufCompressedSkip returns 0.
        That means it probably never gets called... */
     int retval = c;
-    while(c--) {
-	int get = BufFileGet(f);
-	if (get == BUFFILEEOF) return get;
+    while (c > 0) {
+	if (f->left > 0) {
+	    int n = f->left < c ? f->left : c;
+	    f->bufp += n;
+	    f->left -= n;
+	    c -= n;
+	} else {
+	    int get = BufFileGet(f);
+	    if (get == BUFFILEEOF) return get;
+	    c--;
+	}
     }
     return retval;
 }
@@ -207,6 +207,31 @@ FontFileDirectoryChanged(FontDirectoryPtr dir)
  * Make each of the file names an automatic alias for each of the files.
  */
 
+typedef struct _FileNameAlias {
+    char	*name;
+    int		index;		/* of the bitmap entry it names */
+    Bool	present;	/* already in the table */
+} FileNameAliasRec, *FileNameAliasPtr;
+
+static int
+NameCompare(const void *a, const void *b)
+{
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+static int
+FileNameAliasCompare(const void *a, const void *b)
+{
+    FileNameAliasPtr	a_alias = *(FileNameAliasPtr const *) a,
+			b_alias = *(FileNameAliasPtr const *) b;
+    int			result;
+
+    result = strcmp(a_alias->name, b_alias->name);
+    if (result == 0)
+	result = a_alias->index - b_alias->index;
+    return result;
+}
+
 static Bool
 AddFileNameAliases(FontDirectoryPtr dir)
 {
@@ -217,9 +242,28 @@ AddFileNameAliases(FontDirectoryPtr dir)
     FontRendererPtr renderer;
     int		    len;
     FontNameRec	    name;
-
+    char	    **names = NULL;
+    FileNameAliasPtr aliases = NULL, *order = NULL;
+    int		    nnames, naliases = 0, n;
+    Bool	    ret = FALSE;
+
+    /*
+     * The table is not sorted yet, so rather than scanning it once for
+     * every file, sort the existing names and the candidate aliases and
+     * mark the ones already present before adding the rest in their
+     * original order.  Names with wildcards can match more than the
+     * identical name and are still checked against the table.
+     */
     table = &dir->nonScalable;
-    for (i = 0; i < table->used; i++) {
+    nnames = table->used;
+    names = mallocarray(nnames + 1, sizeof(char *));
+    aliases = mallocarray(nnames + 1, sizeof(FileNameAliasRec));
+    order = mallocarray(nnames + 1, sizeof(FileNameAliasPtr));
+    if (!names || !aliases || !order)
+	goto bail;
+
+    for (i = 0; i < nnames; i++) {
+	names[i] = table->entries[i].name.name;
 	if (table->entries[i].type != FONT_ENTRY_BITMAP)
 	    continue;
 	fileName = table->entries[i].u.bitmap.fileName;
@@ -232,16 +276,48 @@ AddFileNameAliases(FontDirectoryPtr dir)
 	    continue;
 	CopyISOLatin1Lowered (copy, fileName, len);
 	copy[len] = '\0';
-	name.name = copy;
-	name.length = len;
-	name.ndashes = FontFileCountDashes (copy, len);
+	if (!(aliases[naliases].name = strdup(copy)))
+	    goto bail;
+	aliases[naliases].index = i;
+	aliases[naliases].present = FALSE;
+	naliases++;
+    }
+    qsort(names, nnames, sizeof(char *), NameCompare);
+
+    for (i = 0, n = 0; i < naliases; i++)
+	if (!strpbrk(aliases[i].name, "*?"))
+	    order[n++] = &aliases[i];
+    qsort(order, n, sizeof(FileNameAliasPtr), FileNameAliasCompare);
+    for (i = 0; i < n; i++) {
+	/* a repeated name is added only for the first file */
+	if ((i > 0 && !strcmp(order[i]->name, order[i - 1]->name)) ||
+	    bsearch(&order[i]->name, names, nnames, sizeof(char *), NameCompare))
+	    order[i]->present = TRUE;
+    }
 
-	if (!FontFileFindNameInDir(table, &name)) {
-	    if (!FontFileAddFontAlias (dir, copy, table->entries[i].name.name))
-		return FALSE;
+    for (i = 0; i < naliases; i++) {
+	if (aliases[i].present)
+	    continue;
+	if (strpbrk(aliases[i].name, "*?")) {
+	    name.name = aliases[i].name;
+	    name.length = strlen(aliases[i].name);
+	    name.ndashes = FontFileCountDashes (name.name, name.length);
+	    if (FontFileFindNameInDir(table, &name))
+		continue;
 	}
+	if (!FontFileAddFontAlias (dir, aliases[i].name,
+				   table->entries[aliases[i].index].name.name))
+	    goto bail;
     }
-    return TRUE;
+    ret = TRUE;
+
+  bail:
+    for (i = 0; i < naliases; i++)
+	free(aliases[i].name);
+    free(order);
+    free(aliases);
+    free(names);
+    return ret;
 }
 
 /*
@@ -42,6 +42,8 @@ in this Software without prior written authorization from The Open Group.
 #define INT32_MAX 0x7fffffff
 #endif
 
+static void FontFileFreeFieldIndex (FontTablePtr table);
+
 Bool
 FontFileInitTable (FontTablePtr table, int size)
 {
@@ -58,6 +60,7 @@ FontFileInitTable (FontTablePtr table, int size)
     table->used = 0;
     table->size = size;
     table->sorted = FALSE;
+    table->fields = NULL;
     return TRUE;
 }
 
@@ -101,6 +104,7 @@ FontFileFreeTable (FontTablePtr table)
     for (i = 0; i < table->used; i++)
 	FontFileFreeEntry (&table->entries[i]);
     free (table->entries);
+    FontFileFreeFieldIndex (table);
 }
 
 FontDirectoryPtr
@@ -182,7 +186,11 @@ FontFileAddEntry(FontTablePtr table, FontEntryPtr prototype)
 	       or more of memory, something is so wrong with this font
 	       directory that we should just give up before we overflow. */
 	    return NULL;
+	/* grow geometrically so that large directories are not copied
+	   once for every hundred entries */
 	newsize = table->size + 100;
+	if (table->size < (INT32_MAX / sizeof(FontEntryRec)) / 2 - 100)
+	    newsize += table->size;
 	entry = reallocarray(table->entries, newsize, sizeof(FontEntryRec));
 	if (!entry)
 	    return (FontEntryPtr)0;
@@ -248,6 +256,55 @@ FontFileNameCompare(const void* a, const void* b)
     return strcmpn(a_name->name.name, b_name->name.name);
 }
 
+/*
+ * While a directory is being read its scalable table is kept in
+ * FontFileNameCompare order, so that the search made for every scaled
+ * bitmap name is a binary search instead of a scan of the whole table.
+ * Returns the index of the matching entry, or -1 with the index at which
+ * the name belongs stored in *slotp.
+ */
+static int
+FontFileFindScalableSlot(FontTablePtr table, const char *name, int *slotp)
+{
+    int	left = 0,
+	right = table->used,
+	center,
+	result;
+
+    while (left < right) {
+	center = (left + right) / 2;
+	result = strcmpn(name, table->entries[center].name.name);
+	if (result == 0) {
+	    *slotp = center;
+	    return center;
+	}
+	if (result < 0)
+	    right = center;
+	else
+	    left = center + 1;
+    }
+    *slotp = left;
+    return -1;
+}
+
+static FontEntryPtr
+FontFileInsertEntry(FontTablePtr table, FontEntryPtr prototype, int slot)
+{
+    FontEntryPtr    entry;
+    FontEntryRec    tmp;
+
+    if (!(entry = FontFileAddEntry (table, prototype)))
+	return (FontEntryPtr) 0;
+    if (slot < table->used - 1) {
+	tmp = *entry;
+	memmove(&table->entries[slot + 1], &table->entries[slot],
+		(table->used - 1 - slot) * sizeof(FontEntryRec));
+	table->entries[slot] = tmp;
+	entry = &table->entries[slot];
+    }
+    return entry;
+}
+
 void
 FontFileSortTable (FontTablePtr table)
 {
@@ -440,6 +497,208 @@ FontFileSaveString (char *s)
 }
 #define FontFileSaveString(s) strdup(s)
 
+/*
+ * Wildcard patterns such as "-*-helvetica-*" can only be narrowed by
+ * SetupWildMatch up to their first wildcard, which for most patterns
+ * leaves the whole table to be matched.  Any run of the pattern that lies
+ * between two dashes and holds no wildcards can only match an identical
+ * field of the name, wherever in the name that field is, so a sorted
+ * table carries an index from each field to the entries containing it.
+ * Matching then visits just the entries of the rarest such field of the
+ * pattern, in table order, and gives the same names as the full scan.
+ */
+
+#define FIELD_INDEX_MIN_ENTRIES	256
+
+typedef struct _FontField {
+    struct _FontField	*next;
+    int			length;
+    int			nentries;
+    int			size;
+    int			*entries;	/* ascending table indices */
+    char		*name;
+} FontFieldRec, *FontFieldPtr;
+
+typedef struct _FontFieldIndex {
+    int			nbuckets;	/* a power of two */
+    FontFieldPtr	*buckets;
+} FontFieldIndexRec, *FontFieldIndexPtr;
+
+static unsigned int
+FontFieldHash(const char *name, int length)
+{
+    unsigned int    hash = 2166136261U;
+
+    while (length--)
+	hash = (hash ^ (unsigned char) *name++) * 16777619U;
+    return hash;
+}
+
+static FontFieldPtr
+FontFileFindField(FontFieldIndexPtr index, const char *name, int length)
+{
+    FontFieldPtr    field;
+
+    field = index->buckets[FontFieldHash(name, length) & (index->nbuckets - 1)];
+    for (; field; field = field->next)
+	if (field->length == length && !memcmp(field->name, name, length))
+	    return field;
+    return NULL;
+}
+
+static Bool
+FontFileIndexField(FontFieldIndexPtr index, const char *name, int length,
+		   int entry)
+{
+    FontFieldPtr    field, *bucket;
+    int		    *entries;
+
+    field = FontFileFindField(index, name, length);
+    if (!field) {
+	field = malloc(sizeof(FontFieldRec) + length);
+	if (!field)
+	    return FALSE;
+	field->name = (char *) (field + 1);
+	memcpy(field->name, name, length);
+	field->length = length;
+	field->nentries = 0;
+	field->size = 0;
+	field->entries = NULL;
+	bucket = &index->buckets[FontFieldHash(name, length) &
+				 (index->nbuckets - 1)];
+	field->next = *bucket;
+	*bucket = field;
+    }
+    /* a name may repeat a field; list each entry once */
+    if (field->nentries && field->entries[field->nentries - 1] == entry)
+	return TRUE;
+    if (field->nentries == field->size) {
+	entries = reallocarray(field->entries, field->size * 2 + 4,
+			       sizeof(int));
+	if (!entries)
+	    return FALSE;
+	field->entries = entries;
+	field->size = field->size * 2 + 4;
+    }
+    field->entries[field->nentries++] = entry;
+    return TRUE;
+}
+
+static void
+FontFileFreeFieldIndex (FontTablePtr table)
+{
+    FontFieldIndexPtr	index = table->fields;
+    FontFieldPtr	field, next;
+    int			i;
+
+    if (!index)
+	return;
+    for (i = 0; i < index->nbuckets; i++)
+	for (field = index->buckets[i]; field; field = next) {
+	    next = field->next;
+	    free(field->entries);
+	    free(field);
+	}
+    free(index->buckets);
+    free(index);
+    table->fields = NULL;
+}
+
+static FontFieldIndexPtr
+FontFileBuildFieldIndex (FontTablePtr table)
+{
+    FontFieldIndexPtr	index;
+    char		*name, *dash;
+    int			i;
+
+    index = malloc(sizeof(FontFieldIndexRec));
+    if (!index)
+	return NULL;
+    index->nbuckets = 256;
+    while (index->nbuckets < table->used && index->nbuckets < (1 << 20))
+	index->nbuckets <<= 1;
+    index->buckets = calloc(index->nbuckets, sizeof(FontFieldPtr));
+    if (!index->buckets) {
+	free(index);
+	return NULL;
+    }
+    table->fields = index;
+    for (i = 0; i < table->used; i++) {
+	name = strchr(table->entries[i].name.name, '-');
+	/* only fields with a dash on either side can match */
+	while (name && (dash = strchr(name + 1, '-'))) {
+	    if (dash > name + 1 &&
+		!FontFileIndexField(index, name + 1, dash - name - 1, i)) {
+		FontFileFreeFieldIndex(table);
+		return NULL;
+	    }
+	    name = dash;
+	}
+    }
+    return index;
+}
+
+/*
+ * Returns the entries in [start, stop) that may match the wildcard
+ * pattern, or NULL if the pattern offers no field to narrow the search.
+ */
+static int *
+FontFileFieldCandidates(FontTablePtr table, FontNamePtr pat,
+			int start, int stop, int *countp)
+{
+    FontFieldIndexPtr	index = table->fields;
+    FontFieldPtr	field, best = NULL;
+    char		*p, *dash;
+    int			*entries;
+    int			left, right, center;
+    static int		none;
+
+    if (!table->sorted || stop - start < FIELD_INDEX_MIN_ENTRIES)
+	return NULL;
+    p = strchr(pat->name, '-');
+    while (p && (dash = strchr(p + 1, '-'))) {
+	if (dash > p + 1 && !memchr(p + 1, '*', dash - p - 1) &&
+	    !memchr(p + 1, '?', dash - p - 1)) {
+	    if (!index && !(index = FontFileBuildFieldIndex(table)))
+		return NULL;
+	    field = FontFileFindField(index, p + 1, dash - p - 1);
+	    if (!field) {
+		*countp = 0;
+		return &none;
+	    }
+	    if (!best || field->nentries < best->nentries)
+		best = field;
+	}
+	p = dash;
+    }
+    if (!best)
+	return NULL;
+
+    /* trim the entry list to the range left by SetupWildMatch */
+    entries = best->entries;
+    left = 0;
+    right = best->nentries;
+    while (left < right) {
+	center = (left + right) / 2;
+	if (entries[center] < start)
+	    left = center + 1;
+	else
+	    right = center;
+    }
+    entries += left;
+    right = best->nentries - left;
+    left = 0;
+    while (left < right) {
+	center = (left + right) / 2;
+	if (entries[center] < stop)
+	    left = center + 1;
+	else
+	    right = center;
+    }
+    *countp = left;
+    return entries;
+}
+
 FontEntryPtr
 FontFileFindNameInScalableDir(FontTablePtr table, FontNamePtr pat,
 			      FontScalablePtr vals)
@@ -449,13 +708,25 @@ FontFileFindNameInScalableDir(FontTablePtr table, FontNamePtr pat,
                 stop,
                 res,
                 private;
+    int		*candidates = NULL,
+		ncandidates = 0,
+		n;
     FontNamePtr	name;
 
     if (!table->entries)
 	return NULL;
     if ((i = SetupWildMatch(table, pat, &start, &stop, &private)) >= 0)
 	return &table->entries[i];
-    for (i = start; i < stop; i++) {
+    if (private >= 0)
+	candidates = FontFileFieldCandidates(table, pat, start, stop,
+					     &ncandidates);
+    for (n = 0; ; n++) {
+	if (candidates) {
+	    if (n >= ncandidates)
+		break;
+	    i = candidates[n];
+	} else if ((i = start + n) >= stop)
+	    break;
 	name = &table->entries[i].name;
 	res = PatternMatch(pat->name, private, name->name, name->ndashes);
 	if (res > 0)
@@ -504,6 +775,9 @@ FontFileFindNamesInScalableDir(FontTablePtr table, FontNamePtr pat, int max,
 		    res,
 		    private;
     int		    ret = Successful;
+    int		    *candidates = NULL,
+		    ncandidates = 0,
+		    n;
     FontEntryPtr    fname;
     FontNamePtr	    name;
 
@@ -520,7 +794,17 @@ FontFileFindNamesInScalableDir(FontTablePtr table, FontNamePtr pat, int max,
 	start = i;
 	stop = i + 1;
     }
-    for (i = start, fname = &table->entries[start]; i < stop; i++, fname++) {
+    if (private >= 0)
+	candidates = FontFileFieldCandidates(table, pat, start, stop,
+					     &ncandidates);
+    for (n = 0; ; n++) {
+	if (candidates) {
+	    if (n >= ncandidates)
+		break;
+	    i = candidates[n];
+	} else if ((i = start + n) >= stop)
+	    break;
+	fname = &table->entries[i];
 	res = PatternMatch(pat->name, private, fname->name.name, fname->name.ndashes);
 	if (res > 0) {
 	    if (vals)
@@ -601,6 +885,7 @@ FontFileMatchName(char *name, int length, FontNamePtr pat)
     table.size = 1;
     table.sorted = TRUE;
     table.entries = entries;
+    table.fields = NULL;
     entries[0].name.name = name;
     entries[0].name.length = length;
     entries[0].name.ndashes = FontFileCountDashes(name, length);
@@ -624,6 +909,7 @@ FontFileAddFontFile (FontDirectoryPtr dir, char *fontName, char *fileName)
     FontEntryPtr	    bitmap = 0, scalable;
     Bool		    isscale;
     Bool		    scalable_xlfd;
+    int			    i, slot;
 
     renderer = FontFileMatchRenderer (fileName);
     if (!renderer)
@@ -708,7 +994,14 @@ FontFileAddFontFile (FontDirectoryPtr dir, char *fontName, char *fileName)
 	    FontParseXLFDName (entry.name.name, &zeroVals,
 			       FONT_XLFD_REPLACE_VALUE);
 	    entry.name.length = strlen (entry.name.name);
-	    existing = FontFileFindNameInDir (&dir->scalable, &entry.name);
+	    if (strpbrk (entry.name.name, "*?"))
+		existing = FontFileFindNameInDir (&dir->scalable, &entry.name);
+	    else if ((i = FontFileFindScalableSlot (&dir->scalable,
+						    entry.name.name,
+						    &slot)) >= 0)
+		existing = &dir->scalable.entries[i];
+	    else
+		existing = (FontEntryPtr) 0;
 	    if (existing)
 	    {
 		if ((vals.values_supplied & POINTSIZE_MASK) ==
@@ -784,7 +1077,8 @@ FontFileAddFontFile (FontDirectoryPtr dir, char *fontName, char *fileName)
 	entry.type = FONT_ENTRY_SCALABLE;
 	entry.u.scalable.renderer = renderer;
 	entry.u.scalable.extra = extra;
-	if (!(scalable = FontFileAddEntry (&dir->scalable, &entry)))
+	(void) FontFileFindScalableSlot (&dir->scalable, entry.name.name, &slot);
+	if (!(scalable = FontFileInsertEntry (&dir->scalable, &entry, slot)))
 	{
 	    free (extra);
 	    free (entry.u.scalable.fileName);
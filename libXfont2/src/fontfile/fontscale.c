@@ -65,6 +65,15 @@ FontFileAddScaledInstance (FontEntryPtr entry, FontScalablePtr vals,
     return TRUE;
 }
 
+static int
+FontEntryNameCompare(const void *a, const void *b)
+{
+    uintptr_t	a_name = (uintptr_t) (*(FontEntryPtr const *) a)->name.name,
+		b_name = (uintptr_t) (*(FontEntryPtr const *) b)->name.name;
+
+    return a_name < b_name ? -1 : a_name > b_name;
+}
+
 /* Must call this after the directory is sorted */
 
 void
@@ -77,9 +86,41 @@ FontFileSwitchStringsToBitmapPointers (FontDirectoryPtr dir)
     FontEntryPtr	    nonScalable;
     FontScaledPtr	    scaled;
     FontScalableExtraPtr    extra;
+    FontEntryPtr	    *byName;
+    FontEntryRec	    key;
+    FontEntryPtr	    keyp, *found;
 
     scalable = dir->scalable.entries;
     nonScalable = dir->nonScalable.entries;
+
+    /*
+     * Look the saved name strings up by address in a sorted index rather
+     * than scanning every bitmap entry for every scaled instance.
+     */
+    byName = mallocarray(dir->nonScalable.used + 1, sizeof(FontEntryPtr));
+    if (byName) {
+	for (b = 0; b < dir->nonScalable.used; b++)
+	    byName[b] = &nonScalable[b];
+	qsort(byName, dir->nonScalable.used, sizeof(FontEntryPtr),
+	      FontEntryNameCompare);
+	keyp = &key;
+	for (s = 0; s < dir->scalable.used; s++)
+	{
+	    extra = scalable[s].u.scalable.extra;
+	    scaled = extra->scaled;
+	    for (i = 0; i < extra->numScaled; i++)
+	    {
+		key.name.name = (char *) scaled[i].bitmap;
+		found = bsearch(&keyp, byName, dir->nonScalable.used,
+				sizeof(FontEntryPtr), FontEntryNameCompare);
+		if (found)
+		    scaled[i].bitmap = *found;
+	    }
+	}
+	free(byName);
+	return;
+    }
+
     for (s = 0; s < dir->scalable.used; s++)
     {
 	extra = scalable[s].u.scalable.extra;
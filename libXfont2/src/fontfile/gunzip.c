@@ -10,11 +10,14 @@
 #include <X11/fonts/bufio.h>
 #include <zlib.h>
 
+/* decompress in chunks much larger than a BufFile's own buffer */
+#define ZIPBUFSIZE	(64 * 1024)
+
 typedef struct _xzip_buf {
   z_stream z;
   int zstat;
-  BufChar b[BUFFILESIZE];
-  BufChar b_in[BUFFILESIZE];
+  BufChar b[ZIPBUFSIZE];
+  BufChar b_in[ZIPBUFSIZE];
   BufFilePtr f;
 } xzip_buf;
 
@@ -51,7 +54,7 @@ BufFilePushZIP (BufFilePtr f)
 
   /* now that the history buffer is allocated, we provide the data buffer */
   x->z.next_out = x->b;
-  x->z.avail_out = BUFFILESIZE;
+  x->z.avail_out = ZIPBUFSIZE;
   x->z.next_out = x->b_in;
   x->z.avail_in = 0;
 
@@ -112,19 +115,14 @@ BufZipFileFill (BufFilePtr f)
   /* now we work to consume what we can */
   /* let zlib know what we can handle */
   x->z.next_out = x->b;
-  x->z.avail_out = BUFFILESIZE;
+  x->z.avail_out = ZIPBUFSIZE;
 
   /* and try to consume all of it */
   while (x->z.avail_out > 0) {
     /* if we don't have anything to work from... */
     if (x->z.avail_in == 0) {
       /* ... fill the z buf from underlying file */
-      int i, c;
-      for (i = 0; i < sizeof(x->b_in); i++) {
-	c = BufFileGet(x->f);
-	if (c == BUFFILEEOF) break;
-	x->b_in[i] = c;
-      }
+      int i = BufFileRead(x->f, (char *) x->b_in, sizeof(x->b_in));
       x->z.avail_in += i;
       x->z.next_in = x->b_in;
     }
@@ -140,7 +138,7 @@ BufZipFileFill (BufFilePtr f)
     }
   }
   f->bufp = x->b;
-  f->left = BUFFILESIZE - x->z.avail_out;
+  f->left = ZIPBUFSIZE - x->z.avail_out;
 
   if (f->left >= 0) {
     f->left--;
@@ -158,9 +156,17 @@ BufZipFileSkip (BufFilePtr f, int c)
      BufCompressedSkip returns 0.
      That means it probably never gets called... */
   int retval = c;
-  while(c--) {
-    int get = BufFileGet(f);
-    if (get == BUFFILEEOF) return get;
+  while (c > 0) {
+    if (f->left > 0) {
+      int n = f->left < c ? f->left : c;
+      f->bufp += n;
+      f->left -= n;
+      c -= n;
+    } else {
+      int get = BufFileGet(f);
+      if (get == BUFFILEEOF) return get;
+      c--;
+    }
   }
   return retval;
 }
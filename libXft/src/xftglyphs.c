@@ -631,6 +631,66 @@ _fill_xrender_bitmap( FT_Bitmap*	target,
     }
 }
 
+/*
+ * Glyphs waiting to be sent to the glyphset in a single AddGlyphs
+ * request.  Images are kept well below the core request size limit so
+ * that the batch never depends on BIG-REQUESTS.
+ */
+#define XFT_BATCH_BYTES	(64 * 1024)
+
+typedef struct _XftGlyphBatch {
+    Glyph	    gids[XFT_NMISSING];
+    XGlyphInfo	    metrics[XFT_NMISSING];
+    unsigned char   *images;
+    int		    nglyph;
+    int		    nbytes;
+} XftGlyphBatch;
+
+static void
+_XftGlyphBatchFlush (Display	    *dpy,
+		     XftFontInt	    *font,
+		     XftGlyphBatch  *batch)
+{
+    if (batch->nglyph)
+	XRenderAddGlyphs (dpy, font->glyphset, batch->gids,
+			  batch->metrics, batch->nglyph,
+			  (char *) batch->images, batch->nbytes);
+    batch->nglyph = 0;
+    batch->nbytes = 0;
+}
+
+/*
+ * Queue one glyph image, which is a whole number of padded scanlines
+ * and so can be sent back to back with the others.  Glyphs that do not
+ * fit in a batch are sent on their own.
+ */
+static void
+_XftGlyphBatchAdd (Display	    *dpy,
+		   XftFontInt	    *font,
+		   XftGlyphBatch    *batch,
+		   Glyph	    glyph,
+		   XGlyphInfo	    *metrics,
+		   unsigned char    *image,
+		   int		    size)
+{
+    if (!batch->images && size <= XFT_BATCH_BYTES)
+	batch->images = malloc (XFT_BATCH_BYTES);
+    if (!batch->images || size > XFT_BATCH_BYTES)
+    {
+	XRenderAddGlyphs (dpy, font->glyphset, &glyph, metrics, 1,
+			  (char *) image, size);
+	return;
+    }
+    if (batch->nglyph == XFT_NMISSING ||
+	batch->nbytes + size > XFT_BATCH_BYTES)
+	_XftGlyphBatchFlush (dpy, font, batch);
+    batch->gids[batch->nglyph] = glyph;
+    batch->metrics[batch->nglyph] = *metrics;
+    batch->nglyph++;
+    memcpy (batch->images + batch->nbytes, image, (size_t) size);
+    batch->nbytes += size;
+}
+
 _X_EXPORT void
 XftFontLoadGlyphs (Display	    *dpy,
 		   XftFont	    *pub,
@@ -660,6 +720,7 @@ XftFontLoadGlyphs (Display	    *dpy,
     FT_Render_Mode  mode = FT_RENDER_MODE_MONO;
     FcBool	    transform;
     FcBool	    glyph_transform;
+    XftGlyphBatch   batch;
 
     if (!info)
 	return;
@@ -689,6 +750,10 @@ XftFontLoadGlyphs (Display	    *dpy,
 
     transform = font->info.transform && mode != FT_RENDER_MODE_MONO;
 
+    batch.images = NULL;
+    batch.nglyph = 0;
+    batch.nbytes = 0;
+
     while (nglyph--)
     {
 	glyphindex = *glyphs++;
@@ -1042,9 +1107,8 @@ XftFontLoadGlyphs (Display	    *dpy,
 		    xftg->glyph_memory += (size_t)size * 255;
 	    }
 	    else
-		XRenderAddGlyphs (dpy, font->glyphset, &glyph,
-				  &xftg->metrics, 1,
-				  (char *) bufBitmap, size);
+		_XftGlyphBatchAdd (dpy, font, &batch, glyph,
+				   &xftg->metrics, bufBitmap, size);
 	}
 	else
 	{
@@ -1104,6 +1168,9 @@ XftFontLoadGlyphs (Display	    *dpy,
 		_XftValidateGlyphUsage(font);
 	}
     }
+    _XftGlyphBatchFlush (dpy, font, &batch);
+    if (batch.images)
+	free (batch.images);
     if (bufBitmap != bufLocal)
 	free (bufBitmap);
     XftUnlockFace (&font->public);
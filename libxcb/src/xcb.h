@@ -240,6 +240,22 @@ typedef struct xcb_auth_info_t {
 
 /* xcb_out.c */
 
+/**
+ * @brief Enables or disables coalescing of drawing requests.
+ * @param c The connection.
+ * @param enable Non-zero to coalesce requests.
+ * @return The previous setting.
+ *
+ * When enabled, an unchecked PolyPoint (with CoordModeOrigin),
+ * PolySegment, PolyRectangle, PolyFillRectangle or PolyFillArc request
+ * that follows one with the same opcode, drawable and GC while that one
+ * is still buffered is appended to it. Both draw the same as
+ * separate requests, but the cookies of coalesced requests share one
+ * sequence number and an error in them is reported only once. Checked
+ * requests are never coalesced.
+ */
+int xcb_set_request_coalescing(xcb_connection_t *c, int enable);
+
 /**
  * @brief Forces any buffered output to be written to the server.
  * @param c The connection to the X server.
@@ -603,6 +619,31 @@ xcb_connection_t *xcb_connect_to_display_with_auth_info(const char *display, xcb
  */
 uint32_t xcb_generate_id(xcb_connection_t *c);
 
+/**
+ * @brief Allocates several XIDs at once.
+ * @param c The connection.
+ * @param ids Array that receives the XIDs.
+ * @param count Number of XIDs to allocate.
+ * @return The number of XIDs stored in @p ids, less than @p count on failure.
+ *
+ * Like calling xcb_generate_id() @p count times, but takes the XID lock
+ * only once.
+ */
+int xcb_generate_ids(xcb_connection_t *c, uint32_t *ids, int count);
+
+/**
+ * @brief Returns an XID for reuse.
+ * @param c The connection.
+ * @param id An XID obtained from xcb_generate_id() or xcb_generate_ids().
+ *
+ * Once the client's own range of XIDs is used up, XIDs given back with
+ * this function are handed out again before asking the server for a
+ * new range, which costs a round trip. Only call it after sending the
+ * request that frees the resource (xcb_free_pixmap, ...) on this
+ * connection, and don't use @p id afterwards.
+ */
+void xcb_free_id(xcb_connection_t *c, uint32_t id);
+
 
 /**
  * @brief Obtain number of bytes read from the connection.
@@ -219,55 +219,48 @@ static int read_setup(xcb_connection_t *c)
     return 1;
 }
 
+#ifdef _WIN32
+/* Number of buffers handed to a single WSASend call. */
+#define XCB_WSABUF_MAX 64
+#endif
+
 /* precondition: there must be something for us to write. */
 static int write_vec(xcb_connection_t *c, struct iovec **vector, int *count)
 {
-#ifndef _WIN32
     int n;
-#endif
 
     assert(!c->out.queue_len);
 
 #ifdef _WIN32
-    /* Could use the WSASend win32 function for scatter/gather i/o but setting up the WSABUF struct from
-       an iovec would require more work and I'm not sure of the benefit....works for now */
-    while (*count)
     {
-        struct iovec *vec = *vector;
-        if (vec->iov_len)
+        /* Gather the vectors into one WSASend call, so a request that is
+         * split over many iovecs (image scanlines, for instance) does not
+         * cost one send per piece. */
+        WSABUF bufs[XCB_WSABUF_MAX];
+        DWORD sent;
+        int i;
+
+        n = *count;
+        if (n > XCB_WSABUF_MAX)
+            n = XCB_WSABUF_MAX;
+        for (i = 0; i < n; i++)
         {
-            int ret = send(c->fd, vec->iov_base, vec->iov_len, 0);
-            if (ret == SOCKET_ERROR)
-            {
-                int err = WSAGetLastError();
-                if (err == WSAEWOULDBLOCK)
-                {
-                    return 1;
-                }
-            }
-            if (ret <= 0)
-            {
-                _xcb_conn_shutdown(c, XCB_CONN_ERROR);
-                return 0;
-            }
-            c->out.total_written += ret;
-            vec->iov_len -= ret;
-            vec->iov_base = (char *)vec->iov_base + ret;
+            bufs[i].buf = (char *) (*vector)[i].iov_base;
+            bufs[i].len = (*vector)[i].iov_len;
         }
-        if (vec->iov_len == 0) {
-            (*vector)++;
-            (*count)--;
+        if (WSASend(c->fd, bufs, n, &sent, 0, NULL, NULL) == SOCKET_ERROR)
+        {
+            if (WSAGetLastError() == WSAEWOULDBLOCK)
+                return 1;
+            n = -1;
         }
+        else
+            n = sent;
     }
-
-    if (!*count)
-        *vector = 0;
-
 #else
     n = *count;
     if (n > IOV_MAX)
         n = IOV_MAX;
-
 #if HAVE_SENDMSG
     if (c->out.out_fd.nfd) {
         union {
@@ -303,6 +296,7 @@ static int write_vec(xcb_connection_t *c, struct iovec **vector, int *count)
         if(n < 0 && errno == EAGAIN)
             return 1;
     }
+#endif /* _WIN32 */
 
     if(n <= 0)
     {
@@ -328,8 +322,6 @@ static int write_vec(xcb_connection_t *c, struct iovec **vector, int *count)
         *vector = 0;
     assert(n == 0);
 
-#endif /* _WIN32 */
-
     return 1;
 }
 
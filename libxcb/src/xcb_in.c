@@ -88,9 +88,10 @@ typedef struct pending_reply {
     uint64_t last_request;
     enum workarounds workaround;
     int flags;
-    struct pending_reply *next;
 } pending_reply;
 
+#define PENDING_REPLIES_INITIAL_SIZE 16
+
 typedef struct reader_list {
     uint64_t request;
     pthread_cond_t *data;
@@ -102,6 +103,37 @@ typedef struct special_list {
     struct special_list *next;
 } special_list;
 
+/* The i'th oldest entry of the pending replies ring. */
+static pending_reply *pending_at(xcb_connection_t *c, unsigned int i)
+{
+    return &c->in.pending_replies[(c->in.pending_replies_head + i) & (c->in.pending_replies_size - 1)];
+}
+
+/* Make room for one more pending reply. The ring is unwrapped into the
+ * new array, so indices relative to the oldest entry stay valid. */
+static int grow_pending_replies(xcb_connection_t *c)
+{
+    unsigned int size = c->in.pending_replies_size ? c->in.pending_replies_size * 2 : PENDING_REPLIES_INITIAL_SIZE;
+    pending_reply *pend;
+    unsigned int i;
+
+    if(c->in.pending_replies_len < c->in.pending_replies_size)
+        return 1;
+    pend = malloc(size * sizeof(pending_reply));
+    if(!pend)
+    {
+        _xcb_conn_shutdown(c, XCB_CONN_CLOSED_MEM_INSUFFICIENT);
+        return 0;
+    }
+    for(i = 0; i < c->in.pending_replies_len; ++i)
+        pend[i] = *pending_at(c, i);
+    free(c->in.pending_replies);
+    c->in.pending_replies = pend;
+    c->in.pending_replies_head = 0;
+    c->in.pending_replies_size = size;
+    return 1;
+}
+
 static void remove_finished_readers(reader_list **prev_reader, uint64_t completed)
 {
     while(*prev_reader && XCB_SEQUENCE_COMPARE((*prev_reader)->request, <=, completed))
@@ -183,7 +215,7 @@ static int read_packet(xcb_connection_t *c)
         return 0;
 
     /* Get the response type, length, and sequence number. */
-    memcpy(&genrep, c->in.queue, sizeof(genrep));
+    memcpy(&genrep, c->in.queue + c->in.queue_start, sizeof(genrep));
 
     /* Compute 32-bit sequence number of this packet. */
     if((genrep.response_type & 0x7f) != XCB_KEYMAP_NOTIFY)
@@ -206,15 +238,12 @@ static int read_packet(xcb_connection_t *c)
             c->in.request_completed = c->in.request_read - 1;
         }
 
-        while(c->in.pending_replies &&
-              c->in.pending_replies->workaround != WORKAROUND_EXTERNAL_SOCKET_OWNER &&
-              XCB_SEQUENCE_COMPARE (c->in.pending_replies->last_request, <=, c->in.request_completed))
+        while(c->in.pending_replies_len &&
+              pending_at(c, 0)->workaround != WORKAROUND_EXTERNAL_SOCKET_OWNER &&
+              XCB_SEQUENCE_COMPARE (pending_at(c, 0)->last_request, <=, c->in.request_completed))
         {
-            pending_reply *oldpend = c->in.pending_replies;
-            c->in.pending_replies = oldpend->next;
-            if(!oldpend->next)
-                c->in.pending_replies_tail = &c->in.pending_replies;
-            free(oldpend);
+            c->in.pending_replies_head = (c->in.pending_replies_head + 1) & (c->in.pending_replies_size - 1);
+            --c->in.pending_replies_len;
         }
 
         if(genrep.response_type == XCB_ERROR)
@@ -225,7 +254,7 @@ static int read_packet(xcb_connection_t *c)
 
     if(genrep.response_type == XCB_ERROR || genrep.response_type == XCB_REPLY)
     {
-        pend = c->in.pending_replies;
+        pend = c->in.pending_replies_len ? pending_at(c, 0) : 0;
         if(pend &&
            !(XCB_SEQUENCE_COMPARE(pend->first_request, <=, c->in.request_read) &&
              (pend->workaround == WORKAROUND_EXTERNAL_SOCKET_OWNER ||
@@ -238,7 +267,7 @@ static int read_packet(xcb_connection_t *c)
     {
         if(pend && pend->workaround == WORKAROUND_GLX_GET_FB_CONFIGS_BUG)
         {
-            uint32_t *p = (uint32_t *) c->in.queue;
+            uint32_t *p = (uint32_t *) (c->in.queue + c->in.queue_start);
             uint64_t new_length = ((uint64_t)p[2]) * ((uint64_t)p[3]);
             if(new_length >= (UINT32_MAX / UINT32_C(16)))
             {
@@ -479,11 +508,14 @@ static void insert_reader(reader_list **prev_reader, reader_list *reader, uint64
 static void remove_reader(reader_list **prev_reader, reader_list *reader)
 {
     while(*prev_reader && XCB_SEQUENCE_COMPARE((*prev_reader)->request, <=, reader->request))
+    {
         if(*prev_reader == reader)
         {
             *prev_reader = (*prev_reader)->next;
             break;
         }
+        prev_reader = &(*prev_reader)->next;
+    }
 }
 
 static void insert_special(special_list **prev_special, special_list *special, xcb_special_event_t *se)
@@ -573,31 +605,29 @@ int *xcb_get_reply_fds(xcb_connection_t *c, void *reply, size_t reply_size)
     return (int *) (&((char *) reply)[reply_size]);
 }
 
-static void insert_pending_discard(xcb_connection_t *c, pending_reply **prev_next, uint64_t seq)
+static void insert_pending_discard(xcb_connection_t *c, unsigned int pos, uint64_t seq)
 {
     pending_reply *pend;
-    pend = malloc(sizeof(*pend));
-    if(!pend)
-    {
-        _xcb_conn_shutdown(c, XCB_CONN_CLOSED_MEM_INSUFFICIENT);
+    unsigned int i;
+
+    if(!grow_pending_replies(c))
         return;
-    }
 
+    for(i = c->in.pending_replies_len; i > pos; --i)
+        *pending_at(c, i) = *pending_at(c, i - 1);
+    ++c->in.pending_replies_len;
+
+    pend = pending_at(c, pos);
     pend->first_request = seq;
     pend->last_request = seq;
     pend->workaround = 0;
     pend->flags = XCB_REQUEST_DISCARD_REPLY;
-    pend->next = *prev_next;
-    *prev_next = pend;
-
-    if(!pend->next)
-        c->in.pending_replies_tail = &pend->next;
 }
 
 static void discard_reply(xcb_connection_t *c, uint64_t request)
 {
     void *reply;
-    pending_reply **prev_pend;
+    unsigned int lo, hi;
 
     /* Free any replies or errors that we've already read. Stop if
      * xcb_wait_for_reply would block or we've run out of replies. */
@@ -608,22 +638,28 @@ static void discard_reply(xcb_connection_t *c, uint64_t request)
     if(XCB_SEQUENCE_COMPARE(request, <=, c->in.request_completed))
         return;
 
-    /* Walk the list of pending requests. Mark the first match for deletion. */
-    for(prev_pend = &c->in.pending_replies; *prev_pend; prev_pend = &(*prev_pend)->next)
+    /* Search the pending requests for the first one not before this
+     * request. If it is this request, mark it for deletion. */
+    lo = 0;
+    hi = c->in.pending_replies_len;
+    while(lo < hi)
     {
-        if(XCB_SEQUENCE_COMPARE((*prev_pend)->first_request, >, request))
-            break;
+        unsigned int mid = lo + (hi - lo) / 2;
+        if(XCB_SEQUENCE_COMPARE(pending_at(c, mid)->first_request, <, request))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
 
-        if((*prev_pend)->first_request == request)
-        {
-            /* Pending reply found. Mark for discard: */
-            (*prev_pend)->flags |= XCB_REQUEST_DISCARD_REPLY;
-            return;
-        }
+    if(lo < c->in.pending_replies_len && pending_at(c, lo)->first_request == request)
+    {
+        /* Pending reply found. Mark for discard: */
+        pending_at(c, lo)->flags |= XCB_REQUEST_DISCARD_REPLY;
+        return;
     }
 
     /* Pending reply not found (likely due to _unchecked request). Create one: */
-    insert_pending_discard(c, prev_pend, request);
+    insert_pending_discard(c, lo, request);
 }
 
 void xcb_discard_reply(xcb_connection_t *c, unsigned int sequence)
@@ -895,6 +931,7 @@ int _xcb_in_init(_xcb_in *in)
         return 0;
     in->reading = 0;
 
+    in->queue_start = 0;
     in->queue_len = 0;
 
     in->request_read = 0;
@@ -906,7 +943,10 @@ int _xcb_in_init(_xcb_in *in)
 
     in->current_reply_tail = &in->current_reply;
     in->events_tail = &in->events;
-    in->pending_replies_tail = &in->pending_replies;
+    in->pending_replies = 0;
+    in->pending_replies_head = 0;
+    in->pending_replies_len = 0;
+    in->pending_replies_size = 0;
 
     return 1;
 }
@@ -923,17 +963,17 @@ void _xcb_in_destroy(_xcb_in *in)
         free(e->event);
         free(e);
     }
-    while(in->pending_replies)
-    {
-        pending_reply *pend = in->pending_replies;
-        in->pending_replies = pend->next;
-        free(pend);
-    }
+    free(in->pending_replies);
 }
 
 void _xcb_in_wake_up_next_reader(xcb_connection_t *c)
 {
     int pthreadret;
+    /* A thread still waiting on the socket hands over when it is done,
+     * and wakes the waiters whose responses it reads; waking anyone now
+     * would only make them go back to sleep. */
+    if(c->in.reading)
+        return;
     if(c->in.readers)
         pthreadret = pthread_cond_signal(c->in.readers->data);
     else if(c->in.special_waiters)
@@ -945,28 +985,23 @@ void _xcb_in_wake_up_next_reader(xcb_connection_t *c)
 
 int _xcb_in_expect_reply(xcb_connection_t *c, uint64_t request, enum workarounds workaround, int flags)
 {
-    pending_reply *pend = malloc(sizeof(pending_reply));
+    pending_reply *pend;
     assert(workaround != WORKAROUND_NONE || flags != 0);
-    if(!pend)
-    {
-        _xcb_conn_shutdown(c, XCB_CONN_CLOSED_MEM_INSUFFICIENT);
+    if(!grow_pending_replies(c))
         return 0;
-    }
+    pend = pending_at(c, c->in.pending_replies_len++);
     pend->first_request = pend->last_request = request;
     pend->workaround = workaround;
     pend->flags = flags;
-    pend->next = 0;
-    *c->in.pending_replies_tail = pend;
-    c->in.pending_replies_tail = &pend->next;
     return 1;
 }
 
 void _xcb_in_replies_done(xcb_connection_t *c)
 {
     struct pending_reply *pend;
-    if (c->in.pending_replies_tail != &c->in.pending_replies)
+    if (c->in.pending_replies_len)
     {
-        pend = container_of(c->in.pending_replies_tail, struct pending_reply, next);
+        pend = pending_at(c, c->in.pending_replies_len - 1);
         if(pend->workaround == WORKAROUND_EXTERNAL_SOCKET_OWNER)
         {
             if (XCB_SEQUENCE_COMPARE(pend->first_request, <=, c->out.request)) {
@@ -976,25 +1011,30 @@ void _xcb_in_replies_done(xcb_connection_t *c)
                 /* The socket was taken, but no requests were actually sent
                  * so just discard the pending_reply that was created.
                  */
-                struct pending_reply **prev_next = &c->in.pending_replies;
-                while (*prev_next != pend)
-                    prev_next = &(*prev_next)->next;
-                *prev_next = NULL;
-                c->in.pending_replies_tail = prev_next;
-                free(pend);
+                --c->in.pending_replies_len;
             }
         }
     }
 }
 
-int _xcb_in_read(xcb_connection_t *c)
+static int read_queue(xcb_connection_t *c, int *filled)
 {
     int n;
+    int space;
+
+    /* Packets are consumed from the front of the queue without moving
+     * the rest; move whatever is left only once per read. */
+    if(c->in.queue_start)
+    {
+        memmove(c->in.queue, c->in.queue + c->in.queue_start, c->in.queue_len);
+        c->in.queue_start = 0;
+    }
+    space = sizeof(c->in.queue) - c->in.queue_len;
 
 #if HAVE_SENDMSG
     struct iovec    iov = {
         .iov_base = c->in.queue + c->in.queue_len,
-        .iov_len = sizeof(c->in.queue) - c->in.queue_len,
+        .iov_len = space,
     };
     union {
         struct cmsghdr cmsghdr;
@@ -1020,7 +1060,7 @@ int _xcb_in_read(xcb_connection_t *c)
         return 0;
     }
 #else
-    n = recv(c->fd, c->in.queue + c->in.queue_len, sizeof(c->in.queue) - c->in.queue_len, 0);
+    n = recv(c->fd, c->in.queue + c->in.queue_len, space, 0);
 #endif
     if(n > 0) {
 #if HAVE_SENDMSG
@@ -1039,6 +1079,7 @@ int _xcb_in_read(xcb_connection_t *c)
         c->in.total_read += n;
         c->in.queue_len += n;
     }
+    *filled = (n == space);
     while(read_packet(c))
         /* empty */;
 #if HAVE_SENDMSG
@@ -1072,15 +1113,28 @@ int _xcb_in_read(xcb_connection_t *c)
     return 0;
 }
 
+int _xcb_in_read(xcb_connection_t *c)
+{
+    int ret, filled;
+
+    /* A read that filled the queue probably left more data in the
+     * socket: keep reading and parsing it now rather than going back to
+     * poll() and waking other threads once per queueful. */
+    do
+        ret = read_queue(c, &filled);
+    while(ret && filled && !c->has_error);
+    return ret;
+}
+
 int _xcb_in_read_block(xcb_connection_t *c, void *buf, int len)
 {
     int done = c->in.queue_len;
     if(len < done)
         done = len;
 
-    memcpy(buf, c->in.queue, done);
+    memcpy(buf, c->in.queue + c->in.queue_start, done);
     c->in.queue_len -= done;
-    memmove(c->in.queue, c->in.queue + done, c->in.queue_len);
+    c->in.queue_start = c->in.queue_len ? c->in.queue_start + done : 0;
 
     if(len > done)
     {
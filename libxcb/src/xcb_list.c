@@ -40,11 +40,50 @@ typedef struct node {
     void *data;
 } node;
 
+/* Keys are request sequence numbers, which are handed out consecutively,
+ * so the low bits make a good hash.  The table grows to keep chains short
+ * when many replies are waiting to be collected. */
+#define XCB_MAP_INITIAL_SIZE 16
+
 struct _xcb_map {
-    node *head;
-    node **tail;
+    node **buckets;
+    unsigned int size;          /* number of buckets, a power of two */
+    unsigned int count;         /* number of entries */
 };
 
+static node **bucket(_xcb_map *list, uint64_t key)
+{
+    return &list->buckets[key & (list->size - 1)];
+}
+
+static int grow(_xcb_map *list)
+{
+    unsigned int size = list->size * 2;
+    node **buckets = calloc(size, sizeof(node *));
+    unsigned int i;
+    if(!buckets)
+        return 0;
+    for(i = 0; i < list->size; ++i)
+    {
+        node *cur = list->buckets[i];
+        while(cur)
+        {
+            node *next = cur->next;
+            node **prev = &buckets[cur->key & (size - 1)];
+            /* keep entries with equal keys in insertion order */
+            while(*prev)
+                prev = &(*prev)->next;
+            cur->next = 0;
+            *prev = cur;
+            cur = next;
+        }
+    }
+    free(list->buckets);
+    list->buckets = buckets;
+    list->size = size;
+    return 1;
+}
+
 /* Private interface */
 
 _xcb_map *_xcb_map_new(void)
@@ -53,50 +92,65 @@ _xcb_map *_xcb_map_new(void)
     list = malloc(sizeof(_xcb_map));
     if(!list)
         return 0;
-    list->head = 0;
-    list->tail = &list->head;
+    list->buckets = calloc(XCB_MAP_INITIAL_SIZE, sizeof(node *));
+    if(!list->buckets)
+    {
+        free(list);
+        return 0;
+    }
+    list->size = XCB_MAP_INITIAL_SIZE;
+    list->count = 0;
     return list;
 }
 
 void _xcb_map_delete(_xcb_map *list, xcb_list_free_func_t do_free)
 {
+    unsigned int i;
     if(!list)
         return;
-    while(list->head)
-    {
-        node *cur = list->head;
-        if(do_free)
-            do_free(cur->data);
-        list->head = cur->next;
-        free(cur);
-    }
+    for(i = 0; i < list->size; ++i)
+        while(list->buckets[i])
+        {
+            node *cur = list->buckets[i];
+            if(do_free)
+                do_free(cur->data);
+            list->buckets[i] = cur->next;
+            free(cur);
+        }
+    free(list->buckets);
     free(list);
 }
 
 int _xcb_map_put(_xcb_map *list, uint64_t key, void *data)
 {
-    node *cur = malloc(sizeof(node));
+    node **prev;
+    node *cur;
+    /* A failed grow just leaves the chains longer. */
+    if(list->count >= list->size)
+        grow(list);
+    cur = malloc(sizeof(node));
     if(!cur)
         return 0;
     cur->key = key;
     cur->data = data;
     cur->next = 0;
-    *list->tail = cur;
-    list->tail = &cur->next;
+    for(prev = bucket(list, key); *prev; prev = &(*prev)->next)
+        /* empty */;
+    *prev = cur;
+    ++list->count;
     return 1;
 }
 
 void *_xcb_map_remove(_xcb_map *list, uint64_t key)
 {
     node **cur;
-    for(cur = &list->head; *cur; cur = &(*cur)->next)
+    for(cur = bucket(list, key); *cur; cur = &(*cur)->next)
         if((*cur)->key == key)
         {
             node *tmp = *cur;
             void *ret = (*cur)->data;
             *cur = (*cur)->next;
-            if(!*cur)
-                list->tail = cur;
+            --list->count;
 
             free(tmp);
             return ret;
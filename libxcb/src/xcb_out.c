@@ -73,6 +73,73 @@ static __inline void send_request(xcb_connection_t *c, int isvoid, enum workarou
     _xcb_out_send(c, vector, count);
 }
 
+/* Size of the fixed part of the core drawing requests that can be
+ * coalesced: opcode, data byte, length, drawable and GC. */
+#define COALESCE_HEADER_SIZE 12
+
+/* Whether more items may be appended to this request, i.e. whether
+ * sending its items in one request or in several draws the same. Checked
+ * requests are excluded so an error is reported for the right cookie. */
+static int can_coalesce(xcb_connection_t *c, const xcb_protocol_request_t *req, int flags,
+                        unsigned int num_fds, struct iovec *vector, int veclen)
+{
+    if(!c->out.coalesce || req->ext || !req->isvoid || flags || num_fds)
+        return 0;
+    /* BIG-REQUESTS prepends a length word; the header must be at hand */
+    if(vector[0].iov_len < COALESCE_HEADER_SIZE || ((uint16_t *) vector[0].iov_base)[1] == 0)
+        return 0;
+    switch(req->opcode)
+    {
+    case XCB_POLY_POINT:
+        /* relative coordinates would continue from the wrong point */
+        return ((uint8_t *) vector[0].iov_base)[1] == XCB_COORD_MODE_ORIGIN;
+    case XCB_POLY_SEGMENT:
+    case XCB_POLY_RECTANGLE:
+    case XCB_POLY_FILL_RECTANGLE:
+    case XCB_POLY_FILL_ARC:
+        return 1;
+    }
+    return 0;
+}
+
+/* Try to append the items of this request to the previous one, which is
+ * for the same drawable and GC. On success the request is sent under the
+ * previous request's sequence number. */
+static int coalesce_request(xcb_connection_t *c, struct iovec *vector, int veclen)
+{
+    char *last = c->out.queue + c->out.last_offset;
+    uint16_t *last_len = (uint16_t *) (last + 2);
+    size_t len = 0;
+    char *dst;
+    int i;
+
+    if(c->out.last_request != c->out.request || c->out.last_offset < 0 ||
+       c->out.last_offset + *last_len * 4 != c->out.queue_len)
+        return 0;
+    if(memcmp(last, vector[0].iov_base, 2) ||
+       memcmp(last + 4, (char *) vector[0].iov_base + 4, COALESCE_HEADER_SIZE - 4))
+        return 0;
+
+    for(i = 0; i < veclen; ++i)
+        len += vector[i].iov_len;
+    len -= COALESCE_HEADER_SIZE;
+    if(*last_len + len / 4 > c->setup->maximum_request_length ||
+       c->out.queue_len + len > sizeof(c->out.queue))
+        return 0;
+
+    dst = c->out.queue + c->out.queue_len;
+    memcpy(dst, (char *) vector[0].iov_base + COALESCE_HEADER_SIZE, vector[0].iov_len - COALESCE_HEADER_SIZE);
+    dst += vector[0].iov_len - COALESCE_HEADER_SIZE;
+    for(i = 1; i < veclen; ++i)
+    {
+        memcpy(dst, vector[i].iov_base, vector[i].iov_len);
+        dst += vector[i].iov_len;
+    }
+    c->out.queue_len += len;
+    *last_len += len / 4;
+    return 1;
+}
+
 static void send_sync(xcb_connection_t *c)
 {
     static const union {
@@ -230,6 +297,7 @@ uint64_t xcb_send_request_with_fds64(xcb_connection_t *c, int flags, struct iove
     uint32_t prefix[2];
     int veclen = req->count;
     enum workarounds workaround = WORKAROUND_NONE;
+    int coalescible;
 
     if(c->has_error) {
         close_fds(fds, num_fds);
@@ -315,6 +383,8 @@ uint64_t xcb_send_request_with_fds64(xcb_connection_t *c, int flags, struct iove
     /* get a sequence number and arrange for delivery. */
     pthread_mutex_lock(&c->iolock);
 
+    coalescible = can_coalesce(c, req, flags, num_fds, vector, veclen);
+
     /* send FDs before establishing a good request number, because this might
      * call send_sync(), too
      */
@@ -336,7 +406,21 @@ uint64_t xcb_send_request_with_fds64(xcb_connection_t *c, int flags, struct iove
         prepare_socket_request(c);
     }
 
-    send_request(c, req->isvoid, workaround, flags, vector, veclen);
+    if(!coalescible || !coalesce_request(c, vector, veclen))
+    {
+        if(coalescible)
+        {
+            /* remember the request if it goes into the queue whole; only
+             * then does send_request keep holding the lock */
+            size_t len = 0;
+            int i;
+            for(i = 0; i < veclen; ++i)
+                len += vector[i].iov_len;
+            c->out.last_offset = c->out.queue_len + len <= sizeof(c->out.queue) ? c->out.queue_len : -1;
+            c->out.last_request = c->out.request + 1;
+        }
+        send_request(c, req->isvoid, workaround, flags, vector, veclen);
+    }
     request = c->has_error ? 0 : c->out.request;
     pthread_mutex_unlock(&c->iolock);
     return request;
@@ -419,6 +503,19 @@ int xcb_writev(xcb_connection_t *c, struct iovec *vector, int count, uint64_t re
     return ret;
 }
 
+int xcb_set_request_coalescing(xcb_connection_t *c, int enable)
+{
+    int ret;
+    if(c->has_error)
+        return 0;
+    pthread_mutex_lock(&c->iolock);
+    ret = c->out.coalesce;
+    c->out.coalesce = enable != 0;
+    c->out.last_offset = -1;
+    pthread_mutex_unlock(&c->iolock);
+    return ret;
+}
+
 int xcb_flush(xcb_connection_t *c)
 {
     int ret;
@@ -446,6 +543,10 @@ int _xcb_out_init(_xcb_out *out)
 
     out->queue_len = 0;
 
+    out->coalesce = 0;
+    out->last_offset = -1;
+    out->last_request = 0;
+
     out->request = 0;
     out->request_written = 0;
     out->request_expected_written = 0;
@@ -36,14 +36,9 @@
 #include "xcbint.h"
 #include "xc_misc.h"
 
-/* Public interface */
-
-uint32_t xcb_generate_id(xcb_connection_t *c)
+/* Allocates one XID; called with the xid lock held. */
+static uint32_t generate_id(xcb_connection_t *c)
 {
-    uint32_t ret;
-    if(c->has_error)
-        return -1;
-    pthread_mutex_lock(&c->xid.lock);
     if(c->xid.last >= c->xid.max - c->xid.inc + 1)
     {
         xcb_xc_misc_get_xid_range_reply_t *range;
@@ -51,14 +46,16 @@ uint32_t xcb_generate_id(xcb_connection_t *c)
         if (c->xid.last == 0) {
             /* finish setting up initial range */
             c->xid.max = c->setup->resource_id_mask;
+        } else if (c->xid.freed_len) {
+            /* reuse an XID the application gave back before asking the
+               server for more */
+            return c->xid.freed[--c->xid.freed_len];
         } else {
             /* check for extension */
             const xcb_query_extension_reply_t *xc_misc_reply =
               xcb_get_extension_data(c, &xcb_xc_misc_id);
-            if (!xc_misc_reply || !xc_misc_reply->present) {
-                pthread_mutex_unlock(&c->xid.lock);
+            if (!xc_misc_reply || !xc_misc_reply->present)
                 return -1;
-            }
             /* get new range */
             range = xcb_xc_misc_get_xid_range_reply(c,
                       xcb_xc_misc_get_xid_range(c), 0);
@@ -66,7 +63,7 @@ uint32_t xcb_generate_id(xcb_connection_t *c)
                when it is out of XIDs.  Sweet. */
             if(!range || (range->start_id == 0 && range->count == 1))
             {
-                pthread_mutex_unlock(&c->xid.lock);
+                free(range);
                 return -1;
             }
             assert(range->count > 0 && range->start_id > 0);
@@ -77,11 +74,63 @@ uint32_t xcb_generate_id(xcb_connection_t *c)
     } else {
         c->xid.last += c->xid.inc;
     }
-    ret = c->xid.last | c->xid.base;
+    return c->xid.last | c->xid.base;
+}
+
+/* Public interface */
+
+uint32_t xcb_generate_id(xcb_connection_t *c)
+{
+    uint32_t ret;
+    if(c->has_error)
+        return -1;
+    pthread_mutex_lock(&c->xid.lock);
+    ret = generate_id(c);
     pthread_mutex_unlock(&c->xid.lock);
     return ret;
 }
 
+int xcb_generate_ids(xcb_connection_t *c, uint32_t *ids, int count)
+{
+    int i;
+    if(c->has_error)
+        return 0;
+    pthread_mutex_lock(&c->xid.lock);
+    for(i = 0; i < count; ++i)
+    {
+        ids[i] = generate_id(c);
+        if(ids[i] == (uint32_t) -1)
+            break;
+    }
+    pthread_mutex_unlock(&c->xid.lock);
+    return i;
+}
+
+void xcb_free_id(xcb_connection_t *c, uint32_t id)
+{
+    if(c->has_error)
+        return;
+    /* only take back XIDs this client could have been given */
+    if((id & ~c->setup->resource_id_mask) != c->xid.base)
+        return;
+    pthread_mutex_lock(&c->xid.lock);
+    if(c->xid.freed_len == c->xid.freed_size)
+    {
+        int size = c->xid.freed_size ? c->xid.freed_size * 2 : 64;
+        uint32_t *freed = realloc(c->xid.freed, size * sizeof(uint32_t));
+        if(!freed)
+        {
+            /* not fatal: the XID is simply not reused */
+            pthread_mutex_unlock(&c->xid.lock);
+            return;
+        }
+        c->xid.freed = freed;
+        c->xid.freed_size = size;
+    }
+    c->xid.freed[c->xid.freed_len++] = id;
+    pthread_mutex_unlock(&c->xid.lock);
+}
+
 /* Private interface */
 
 int _xcb_xid_init(xcb_connection_t *c)
@@ -92,6 +141,9 @@ int _xcb_xid_init(xcb_connection_t *c)
     c->xid.max = 0;
     c->xid.base = c->setup->resource_id_base;
     c->xid.inc = c->setup->resource_id_mask & -(c->setup->resource_id_mask);
+    c->xid.freed = 0;
+    c->xid.freed_len = 0;
+    c->xid.freed_size = 0;
     return 1;
 }
 
@@ -100,4 +152,5 @@ void _xcb_xid_destroy(xcb_connection_t *c)
     if (!c->xid.lock)
       return; /* mutex was not initialised yet */
     pthread_mutex_destroy(&c->xid.lock);
+    free(c->xid.freed);
 }
@@ -111,6 +111,12 @@ typedef struct _xcb_out {
     char queue[XCB_QUEUE_BUFFER_SIZE];
     int queue_len;
 
+    /* Request coalescing: the last request, if it can take more items,
+     * is still whole in queue at last_offset. */
+    int coalesce;
+    int last_offset;
+    uint64_t last_request;
+
     uint64_t request;
     uint64_t request_written;
     uint64_t request_expected_written;
@@ -141,7 +147,10 @@ typedef struct _xcb_in {
     pthread_cond_t event_cond;
     int reading;
 
-    char queue[4096];
+    /* Unparsed input is queue[queue_start] .. queue[queue_start + queue_len - 1].
+     * Large enough to take a burst of replies and events in one read. */
+    char queue[16384];
+    int queue_start;
     int queue_len;
 
     uint64_t request_expected;
@@ -157,8 +166,12 @@ typedef struct _xcb_in {
     struct reader_list *readers;
     struct special_list *special_waiters;
 
+    /* Ring buffer of requests needing special reply handling, ordered
+     * by sequence number. */
     struct pending_reply *pending_replies;
-    struct pending_reply **pending_replies_tail;
+    unsigned int pending_replies_head;
+    unsigned int pending_replies_len;
+    unsigned int pending_replies_size;
 #if HAVE_SENDMSG
     _xcb_fd in_fd;
 #endif
@@ -185,6 +198,9 @@ typedef struct _xcb_xid {
     uint32_t base;
     uint32_t max;
     uint32_t inc;
+    uint32_t *freed;     /* XIDs returned with xcb_free_id */
+    int freed_len;
+    int freed_size;
 } _xcb_xid;
 
 int _xcb_xid_init(xcb_connection_t *c);
@@ -0,0 +1,247 @@
+#include <check.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "check_suites.h"
+#include "xcb.h"
+#include "xcbext.h"
+
+/* XID allocation tests {{{ */
+
+/* The tests talk to a fake server, a child process at the other end of
+   a socket pair.  It answers each request the client sends with the next
+   reply of a script set up by the test. */
+
+#define XID_BASE 0x00400000
+#define XID_MASK 0x0000007f
+#define XID_COUNT (XID_MASK + 1)
+
+static uint8_t script[8][32];
+static int script_len;
+static pid_t server_pid;
+
+static int read_all(int fd, void *buf, size_t len)
+{
+	ssize_t n;
+
+	while(len)
+	{
+		n = read(fd, buf, len);
+		if(n <= 0)
+			return 0;
+		buf = (char *) buf + n;
+		len -= n;
+	}
+	return 1;
+}
+
+static void serve(int fd)
+{
+	xcb_setup_request_t req;
+	xcb_setup_t setup;
+	uint8_t body[256];
+	uint16_t header[2];
+	uint16_t sequence = 0;
+	size_t len;
+
+	/* the client sends no authorization */
+	if(!read_all(fd, &req, sizeof(req)))
+		_exit(1);
+
+	memset(&setup, 0, sizeof(setup));
+	setup.status = 1;
+	setup.protocol_major_version = 11;
+	setup.length = (sizeof(setup) - 8) / 4;
+	setup.resource_id_base = XID_BASE;
+	setup.resource_id_mask = XID_MASK;
+	setup.maximum_request_length = 0xffff;
+	if(write(fd, &setup, sizeof(setup)) != sizeof(setup))
+		_exit(1);
+
+	while(read_all(fd, header, sizeof(header)))
+	{
+		len = header[1] * 4 - sizeof(header);
+		if(len > sizeof(body) || !read_all(fd, body, len) || sequence == script_len)
+			_exit(1);
+		++sequence;
+		memcpy(script[sequence - 1] + 2, &sequence, 2);
+		if(write(fd, script[sequence - 1], 32) != 32)
+			_exit(1);
+	}
+	_exit(0);
+}
+
+static xcb_connection_t *connect_fake_server(void)
+{
+	xcb_connection_t *c;
+	int sv[2];
+
+	ck_assert_msg(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0, "socketpair failed");
+	server_pid = fork();
+	ck_assert_msg(server_pid >= 0, "fork failed");
+	if(server_pid == 0)
+	{
+		close(sv[0]);
+		serve(sv[1]);
+	}
+	close(sv[1]);
+
+	c = xcb_connect_to_fd(sv[0], 0);
+	ck_assert_msg(!xcb_connection_has_error(c), "connection to fake server failed");
+	return c;
+}
+
+static void disconnect_fake_server(xcb_connection_t *c)
+{
+	int status;
+
+	xcb_disconnect(c);
+	waitpid(server_pid, &status, 0);
+	ck_assert_msg(WIFEXITED(status) && WEXITSTATUS(status) == 0, "fake server got unexpected requests");
+	script_len = 0;
+}
+
+/* Script the reply to the client's QueryExtension for XC-MISC. */
+static void reply_xc_misc_present(void)
+{
+	xcb_query_extension_reply_t rep;
+
+	memset(&rep, 0, sizeof(rep));
+	rep.response_type = 1;
+	rep.present = 1;
+	rep.major_opcode = 128;
+	memset(script[script_len], 0, 32);
+	memcpy(script[script_len++], &rep, sizeof(rep));
+}
+
+/* Script the reply to one of the client's XC-MISC GetXIDRange requests. */
+static void reply_xid_range(uint32_t start_id, uint32_t count)
+{
+	uint8_t *rep = script[script_len++];
+
+	memset(rep, 0, 32);
+	rep[0] = 1;
+	memcpy(rep + 8, &start_id, 4);
+	memcpy(rep + 12, &count, 4);
+}
+
+static void check_fresh_ids(const uint32_t *ids, int n)
+{
+	int i;
+
+	for(i = 0; i < n; ++i)
+	{
+		ck_assert_msg(ids[i] == (XID_BASE | i), "unexpected XID %08x at %d", ids[i], i);
+	}
+}
+
+START_TEST(xid_exhaustion)
+{
+	xcb_connection_t *c;
+	uint32_t ids[XID_COUNT];
+	int n;
+
+	/* the server has no XIDs left: a range reply of start 0, count 1 */
+	reply_xc_misc_present();
+	reply_xid_range(0, 1);
+	reply_xid_range(0, 1);
+	c = connect_fake_server();
+
+	n = xcb_generate_ids(c, ids, XID_COUNT);
+	ck_assert_msg(n == XID_COUNT, "got %d XIDs of the initial %d", n, XID_COUNT);
+	check_fresh_ids(ids, n);
+
+	ck_assert_msg(xcb_generate_id(c) == (uint32_t) -1, "XID given out after exhaustion");
+	ck_assert_msg(!xcb_connection_has_error(c), "exhaustion broke the connection");
+
+	/* a batch stops at the first failure and reports what it got */
+	n = xcb_generate_ids(c, ids, 8);
+	ck_assert_msg(n == 0, "got %d XIDs after exhaustion", n);
+
+	disconnect_fake_server(c);
+}
+END_TEST
+
+START_TEST(xid_free_list)
+{
+	xcb_connection_t *c;
+	uint32_t ids[XID_COUNT];
+	uint32_t id;
+	int i, n;
+
+	reply_xc_misc_present();
+	reply_xid_range(0, 1);
+	c = connect_fake_server();
+
+	n = xcb_generate_ids(c, ids, XID_COUNT);
+	ck_assert_msg(n == XID_COUNT, "got %d XIDs of the initial %d", n, XID_COUNT);
+
+	/* XIDs of other clients are ignored; the free list grows past
+	   its initial size of 64 */
+	xcb_free_id(c, 0x00800001);
+	xcb_free_id(c, 0);
+	for(i = 0; i < XID_COUNT; ++i)
+		xcb_free_id(c, ids[i]);
+
+	/* freed XIDs come back, most recent first, before the server is
+	   asked for more */
+	for(i = XID_COUNT - 1; i >= 0; --i)
+	{
+		id = xcb_generate_id(c);
+		ck_assert_msg(id == ids[i], "got XID %08x instead of freed %08x", id, ids[i]);
+	}
+
+	/* once the free list is empty again the server is asked */
+	xcb_free_id(c, ids[3]);
+	n = xcb_generate_ids(c, ids, 2);
+	ck_assert_msg(n == 1, "got %d XIDs from a free list of 1", n);
+	ck_assert_msg(ids[0] == (XID_BASE | 3), "got XID %08x instead of freed %08x", ids[0], XID_BASE | 3);
+
+	disconnect_fake_server(c);
+}
+END_TEST
+
+START_TEST(xid_get_range)
+{
+	xcb_connection_t *c;
+	uint32_t ids[XID_COUNT];
+	int i, n;
+
+	/* the server hands back a range of 5 XIDs, then one of 2, then
+	   has no more */
+	reply_xc_misc_present();
+	reply_xid_range(0x10, 5);
+	reply_xid_range(0x20, 2);
+	reply_xid_range(0, 1);
+	c = connect_fake_server();
+
+	n = xcb_generate_ids(c, ids, XID_COUNT);
+	ck_assert_msg(n == XID_COUNT, "got %d XIDs of the initial %d", n, XID_COUNT);
+	check_fresh_ids(ids, n);
+
+	n = xcb_generate_ids(c, ids, 5);
+	ck_assert_msg(n == 5, "got %d XIDs of the range's 5", n);
+	for(i = 0; i < n; ++i)
+		ck_assert_msg(ids[i] == (XID_BASE | (0x10 + i)), "unexpected XID %08x from range at %d", ids[i], i);
+
+	/* a batch spanning two ranges asks for the second one in between */
+	n = xcb_generate_ids(c, ids, 4);
+	ck_assert_msg(n == 2, "got %d XIDs of the second range's 2", n);
+	ck_assert_msg(ids[0] == (XID_BASE | 0x20) && ids[1] == (XID_BASE | 0x21), "unexpected XIDs %08x %08x from second range", ids[0], ids[1]);
+
+	disconnect_fake_server(c);
+}
+END_TEST
+
+/* }}} */
+
+Suite *xid_suite(void)
+{
+	Suite *s = suite_create("XID allocation");
+	suite_add_test(s, xid_exhaustion, "xcb_generate_ids exhaustion");
+	suite_add_test(s, xid_free_list, "xcb_free_id free list");
+	suite_add_test(s, xid_get_range, "xcb_generate_ids GetXIDRange");
+	return s;
+}
@@ -859,6 +859,7 @@ CompileKeycodes(XkbFile * file, XkbFileInfo * result, unsigned merge)
                 uDEBUG2(2, "key %d = %s\n", i,
                         XkbKeyNameText(xkb->names->keys[i].name, XkbMessage));
             }
+            ResetKeyNameIndex();
         }
         else
         {
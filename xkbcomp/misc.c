@@ -63,6 +63,9 @@ ProcessIncludeFile(IncludeStmt * stmt,
         /* file not in cache, open it, parse it and store it in cache for next
            time. */
         FILE *file = XkbFindFileInPath(stmt->file, file_type, &stmt->path);
+        clock_t parseStart;
+        int ok;
+
         if (file == NULL)
         {
             ERROR("Can't find file \"%s\" for %s include\n", stmt->file,
@@ -78,7 +81,10 @@ ProcessIncludeFile(IncludeStmt * stmt,
             INFO("About to parse include file %s\n", stmt->file);
 #endif
         /* parse the file */
-        if ((XKBParseFile(file, &rtrn) == 0) || (rtrn == NULL))
+        parseStart = clock();
+        ok = XKBParseFile(file, &rtrn);
+        includeParseTime += clock() - parseStart;
+        if ((ok == 0) || (rtrn == NULL))
         {
             setScanState(oldFile, oldLine);
             ERROR("Error interpreting include file \"%s\"\n", stmt->file);
@@ -483,9 +489,87 @@ ComputeKbdDefaults(XkbDescPtr xkb)
             }
         }
     }
+    ResetKeyNameIndex();
     return Success;
 }
 
+/***====================================================================***/
+
+/*
+ * FindNamedKey() is called for every key of every symbols, alias and
+ * geometry section, so key names are looked up through a hash table
+ * mapping names to the lowest key code carrying them instead of
+ * scanning all key codes.  Anything that changes key names must call
+ * ResetKeyNameIndex(); the table is then rebuilt on the next lookup.
+ */
+#define KEY_NAME_INDEX_SIZE 1024  /* power of two, > 2 * XkbMaxLegalKeyCode */
+
+static struct
+{
+    XkbDescPtr xkb;
+    XkbKeyNamePtr keys;
+    int minKC, maxKC;
+    unsigned long names[KEY_NAME_INDEX_SIZE];
+    short kcs[KEY_NAME_INDEX_SIZE];     /* -1 for empty slots */
+} keyNameIndex;
+
+void
+ResetKeyNameIndex(void)
+{
+    keyNameIndex.xkb = NULL;
+}
+
+static unsigned
+KeyNameHash(unsigned long name)
+{
+    return ((name * 2654435761UL) >> 8) & (KEY_NAME_INDEX_SIZE - 1);
+}
+
+/**
+ * Returns the lowest key code named name, or -1 if there is none.
+ */
+static int
+KeyNameIndexLookup(XkbDescPtr xkb, unsigned long name)
+{
+    unsigned h;
+
+    if ((keyNameIndex.xkb != xkb) ||
+        (keyNameIndex.keys != xkb->names->keys) ||
+        (keyNameIndex.minKC != xkb->min_key_code) ||
+        (keyNameIndex.maxKC != xkb->max_key_code))
+    {
+        memset(keyNameIndex.kcs, -1, sizeof(keyNameIndex.kcs));
+        for (int n = xkb->min_key_code; n <= xkb->max_key_code; n++)
+        {
+            unsigned long tmp = KeyNameToLong(xkb->names->keys[n].name);
+
+            for (h = KeyNameHash(tmp); keyNameIndex.kcs[h] >= 0;
+                 h = (h + 1) & (KEY_NAME_INDEX_SIZE - 1))
+            {
+                if (keyNameIndex.names[h] == tmp)
+                    break;
+            }
+            if (keyNameIndex.kcs[h] < 0)
+            {
+                keyNameIndex.names[h] = tmp;
+                keyNameIndex.kcs[h] = n;
+            }
+        }
+        keyNameIndex.xkb = xkb;
+        keyNameIndex.keys = xkb->names->keys;
+        keyNameIndex.minKC = xkb->min_key_code;
+        keyNameIndex.maxKC = xkb->max_key_code;
+    }
+
+    for (h = KeyNameHash(name); keyNameIndex.kcs[h] >= 0;
+         h = (h + 1) & (KEY_NAME_INDEX_SIZE - 1))
+    {
+        if (keyNameIndex.names[h] == name)
+            return keyNameIndex.kcs[h];
+    }
+    return -1;
+}
+
 /**
  * Find the key with the given name and return its keycode in kc_rtrn.
  *
@@ -516,7 +600,21 @@ FindNamedKey(XkbDescPtr xkb,
     *kc_rtrn = 0;               /* some callers rely on this */
     if (xkb && xkb->names && xkb->names->keys)
     {
-        for (unsigned n = start_from; n <= xkb->max_key_code; n++)
+        int kc = KeyNameIndexLookup(xkb, name);
+
+        if ((kc >= 0) && (KeyNameToLong(xkb->names->keys[kc].name) != name))
+        {
+            /* someone changed a name without telling us */
+            ResetKeyNameIndex();
+            kc = KeyNameIndexLookup(xkb, name);
+        }
+        if (kc >= start_from)
+        {
+            *kc_rtrn = kc;
+            return True;
+        }
+        /* only look further if the name is also used below start_from */
+        for (unsigned n = start_from; kc >= 0 && n <= xkb->max_key_code; n++)
         {
             unsigned long tmp;
             tmp = KeyNameToLong(xkb->names->keys[n].name);
@@ -561,6 +659,7 @@ FindNamedKey(XkbDescPtr xkb,
                 char buf[XkbKeyNameLength + 1];
                 LongToKeyName(name, buf);
                 memcpy(xkb->names->keys[n].name, buf, XkbKeyNameLength);
+                ResetKeyNameIndex();
                 *kc_rtrn = n;
                 return True;
             }
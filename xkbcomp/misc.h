@@ -89,6 +89,8 @@ extern Bool ProcessIncludeFile(IncludeStmt * /* stmt */ ,
 extern Status ComputeKbdDefaults(XkbDescPtr     /* xkb */
     );
 
+extern void ResetKeyNameIndex(void);
+
 extern Bool FindNamedKey(XkbDescPtr /* xkb */ ,
                          unsigned long /* name */ ,
                          unsigned int * /* kc_rtrn */ ,
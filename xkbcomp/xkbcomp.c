@@ -90,11 +90,13 @@ static Display *inDpy;
 static Display *outDpy;
 static Bool showImplicit = False;
 static Bool synch = False;
+static Bool reportTimes = False;
 static Bool computeDflts = False;
 static Bool xkblist = False;
 unsigned warningLevel = 5;
 unsigned verboseLevel = 0;
 unsigned dirsToStrip = 0;
+clock_t includeParseTime = 0;
 static unsigned optionalParts = 0;
 static const char *preErrorMsg = NULL;
 static const char *postErrorMsg = NULL;
@@ -160,6 +162,10 @@ Usage(int argc, char *argv[])
     M("-R[<DIR>]            Specifies the root directory for\n");
     M("                     relative path names\n");
     M("-synch               Force synchronization\n");
+    if (!xkblist)
+    {
+        M("-time                Report time spent parsing and compiling\n");
+    }
     if (xkblist)
     {
         M("-v [<flags>]         Set level of detail for listing.\n");
@@ -563,6 +569,10 @@ parseArgs(int argc, char *argv[])
         {
             synch = True;
         }
+        else if ((strcmp(argv[i], "-time") == 0) && (!xkblist))
+        {
+            reportTimes = True;
+        }
         else if (strncmp(argv[i], "-v", 2) == 0)
         {
             const char *str;
@@ -984,11 +994,14 @@ main(int argc, char *argv[])
     }
     if (file)
     {
+        clock_t start = clock(), parsed = start;
+
         ok = True;
         setScanState(inputFile, 1);
         if ((inputFormat == INPUT_XKB) /* parse .xkb file */
             && (XKBParseFile(file, &rtrn) && (rtrn != NULL)))
         {
+            parsed = clock();
             fclose(file);
             mapToUse = rtrn;
             if (inputMap != NULL) /* map specified on cmdline? */
@@ -1068,6 +1081,20 @@ main(int argc, char *argv[])
                 break;
             }
             result.xkb->device_spec = device_id;
+
+            if (reportTimes)
+            {
+                clock_t done = clock();
+
+                fprintf(stderr,
+                        "xkbcomp: parse %.2f ms (includes %.2f ms), "
+                        "compile %.2f ms\n",
+                        (parsed - start + includeParseTime) * 1000.0 /
+                        CLOCKS_PER_SEC,
+                        includeParseTime * 1000.0 / CLOCKS_PER_SEC,
+                        (done - parsed - includeParseTime) * 1000.0 /
+                        CLOCKS_PER_SEC);
+            }
         }
         else if (inputFormat == INPUT_XKM) /* parse xkm file */
         {
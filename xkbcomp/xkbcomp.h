@@ -39,6 +39,8 @@
 #include <X11/Xlib.h>
 #include <X11/XKBlib.h>
 
+#include <time.h>
+
 #include "utils.h"
 
 #include <X11/extensions/XKM.h>
@@ -116,6 +118,8 @@ typedef struct _ParseCommon
 
 extern unsigned warningLevel;
 
+extern clock_t includeParseTime;
+
 typedef struct _IncludeStmt
 {
     ParseCommon common;
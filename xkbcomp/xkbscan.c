@@ -575,11 +575,57 @@ static struct _Keyword
 };
 static int numKeywords = sizeof(keywords) / sizeof(struct _Keyword);
 
+/*
+ * Every identifier (including every keysym name) is checked against the
+ * keyword list, so the keywords are kept in a case-insensitive hash table
+ * built on first use.  Slots hold an index into keywords[] plus one.
+ */
+#define	KEYWORD_HASH_SIZE	256
+
+static unsigned char keywordHash[KEYWORD_HASH_SIZE];
+
+static unsigned
+KeywordHashValue(const char *str)
+{
+    unsigned h = 0;
+
+    while (*str)
+        h = (h * 31) + tolower((unsigned char) *str++);
+    return h & (KEYWORD_HASH_SIZE - 1);
+}
+
+static int
+LookupKeyword(const char *str)
+{
+    static int initialized = 0;
+    unsigned h;
+
+    if (!initialized)
+    {
+        for (int i = 0; i < numKeywords; i++)
+        {
+            for (h = KeywordHashValue(keywords[i].keyword); keywordHash[h];
+                 h = (h + 1) & (KEYWORD_HASH_SIZE - 1))
+                ;
+            keywordHash[h] = i + 1;
+        }
+        initialized = 1;
+    }
+
+    for (h = KeywordHashValue(str); keywordHash[h];
+         h = (h + 1) & (KEYWORD_HASH_SIZE - 1))
+    {
+        if (uStrCaseCmp(str, keywords[keywordHash[h] - 1].keyword) == 0)
+            return keywords[keywordHash[h] - 1].token;
+    }
+    return -1;
+}
+
 static int
 yyGetIdent(int first)
 {
-    int ch, j, found;
-    int rtrn = IDENT;
+    int ch, j;
+    int rtrn;
 
     scanBuf[0] = first;
     j = 1;
@@ -589,17 +635,9 @@ yyGetIdent(int first)
             scanBuf[j++] = ch;
     }
     scanBuf[j++] = '\0';
-    found = 0;
 
-    for (int i = 0; (!found) && (i < numKeywords); i++)
-    {
-        if (uStrCaseCmp(scanBuf, keywords[i].keyword) == 0)
-        {
-            rtrn = keywords[i].token;
-            found = 1;
-        }
-    }
-    if (!found)
+    rtrn = LookupKeyword(scanBuf);
+    if (rtrn < 0)
     {
         scanStrLine = lineNum;
         rtrn = IDENT;
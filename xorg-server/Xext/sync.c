@@ -113,6 +113,10 @@ static const char *WARN_INVALID_COUNTER_ALARM =
 
 static void SyncComputeBracketValues(SyncCounter *);
 
+static int SyncIndexAddTrigger(SyncCounter *, SyncTrigger *);
+
+static void SyncIndexDeleteTrigger(SyncCounter *, SyncTrigger *);
+
 static void SyncInitServerTime(void);
 
 static void SyncInitIdleTime(void);
@@ -177,6 +181,8 @@ SyncDeleteTriggerFromSyncObject(SyncTrigger * pTrigger)
     if (SYNC_COUNTER == pTrigger->pSync->type) {
         pCounter = (SyncCounter *) pTrigger->pSync;
 
+        SyncIndexDeleteTrigger(pCounter, pTrigger);
+
         if (IsSystemCounter(pCounter))
             SyncComputeBracketValues(pCounter);
     }
@@ -205,6 +211,13 @@ SyncAddTriggerToSyncObject(SyncTrigger * pTrigger)
     if (!(pCur = malloc(sizeof(SyncTriggerList))))
         return BadAlloc;
 
+    if (SYNC_COUNTER == pTrigger->pSync->type &&
+        SyncIndexAddTrigger((SyncCounter *) pTrigger->pSync,
+                            pTrigger) != Success) {
+        free(pCur);
+        return BadAlloc;
+    }
+
     pCur->pTrigger = pTrigger;
     pCur->next = pTrigger->pSync->pTriglist;
     pTrigger->pSync->pTriglist = pCur;
@@ -313,12 +326,227 @@ SyncCheckTriggerFence(SyncTrigger * pTrigger, int64_t unused)
     return (pFence == NULL || pFence->funcs.CheckTriggered(pFence));
 }
 
+/*  Each counter also files its triggers in an index with one array per
+ *  test type, sorted by test value.  The arrays are keyed by the
+ *  CheckTrigger function rather than test_type, because that is what
+ *  decides whether a trigger fires.  Whenever a trigger's test value or
+ *  test type changes while it is registered on a counter, it has to be
+ *  refiled with SyncIndexUpdateTrigger().
+ */
+static int
+SyncIndexSlot(SyncTrigger * pTrigger)
+{
+    if (pTrigger->CheckTrigger == SyncCheckTriggerPositiveTransition)
+        return SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION;
+    if (pTrigger->CheckTrigger == SyncCheckTriggerNegativeTransition)
+        return SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION;
+    if (pTrigger->CheckTrigger == SyncCheckTriggerPositiveComparison)
+        return SYNC_TRIGGER_INDEX_POSITIVE_COMPARISON;
+    if (pTrigger->CheckTrigger == SyncCheckTriggerNegativeComparison)
+        return SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON;
+    return -1;
+}
+
+/* first entry whose test value is >= value */
+static int
+SyncIndexLowerBound(SyncTriggerIndex * pIndex, int64_t value)
+{
+    int lo = 0, hi = pIndex->num;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+
+        if (pIndex->entries[mid].value < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* first entry whose test value is > value */
+static int
+SyncIndexUpperBound(SyncTriggerIndex * pIndex, int64_t value)
+{
+    int lo = 0, hi = pIndex->num;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+
+        if (pIndex->entries[mid].value <= value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* make room for one more entry */
+static int
+SyncIndexGrow(SyncTriggerIndex * pIndex)
+{
+    if (pIndex->num == pIndex->size) {
+        int size = pIndex->size ? pIndex->size * 2 : 8;
+        SyncTriggerIndexEntry *entries;
+
+        entries = reallocarray(pIndex->entries, size,
+                               sizeof(SyncTriggerIndexEntry));
+        if (!entries)
+            return BadAlloc;
+        pIndex->entries = entries;
+        pIndex->size = size;
+    }
+    return Success;
+}
+
+static int
+SyncIndexAddTrigger(SyncCounter * pCounter, SyncTrigger * pTrigger)
+{
+    SyncTriggerIndex *pIndex;
+    int slot = SyncIndexSlot(pTrigger);
+    int pos;
+
+    pTrigger->index_slot = -1;
+    if (slot < 0)
+        return Success;
+
+    pIndex = &pCounter->trigIndex[slot];
+    if (SyncIndexGrow(pIndex) != Success)
+        return BadAlloc;
+
+    pos = SyncIndexUpperBound(pIndex, pTrigger->test_value);
+    memmove(&pIndex->entries[pos + 1], &pIndex->entries[pos],
+            (pIndex->num - pos) * sizeof(SyncTriggerIndexEntry));
+    pIndex->entries[pos].value = pTrigger->test_value;
+    pIndex->entries[pos].pTrigger = pTrigger;
+    pIndex->num++;
+    pTrigger->index_slot = slot;
+
+    return Success;
+}
+
+typedef struct _SyncTriggerFiring {
+    SyncTrigger **triggers;
+    int num;
+    int cur;
+    struct _SyncTriggerFiring *next;
+} SyncTriggerFiring;
+
+/* remove the entry filed under value, if any */
+static void
+SyncIndexRemove(SyncCounter * pCounter, SyncTrigger * pTrigger, int64_t value)
+{
+    SyncTriggerIndex *pIndex = &pCounter->trigIndex[pTrigger->index_slot];
+    int pos;
+
+    pTrigger->index_slot = -1;
+
+    for (pos = SyncIndexLowerBound(pIndex, value);
+         pos < pIndex->num && pIndex->entries[pos].value == value; pos++) {
+        if (pIndex->entries[pos].pTrigger == pTrigger)
+            goto found;
+    }
+
+    /* the test value changed behind our back; fall back to a full scan */
+    for (pos = 0; pos < pIndex->num; pos++) {
+        if (pIndex->entries[pos].pTrigger == pTrigger)
+            goto found;
+    }
+    return;
+
+ found:
+    pIndex->num--;
+    memmove(&pIndex->entries[pos], &pIndex->entries[pos + 1],
+            (pIndex->num - pos) * sizeof(SyncTriggerIndexEntry));
+}
+
+static void
+SyncIndexDeleteTrigger(SyncCounter * pCounter, SyncTrigger * pTrigger)
+{
+    SyncTriggerFiring *pFiring;
+    int pos;
+
+    /* A trigger deleted while SyncChangeCounter() is running the
+     * counter's triggers must not be run afterwards; it may be freed.
+     */
+    for (pFiring = pCounter->pFiring; pFiring; pFiring = pFiring->next) {
+        for (pos = pFiring->cur; pos < pFiring->num; pos++) {
+            if (pFiring->triggers[pos] == pTrigger)
+                pFiring->triggers[pos] = NULL;
+        }
+    }
+
+    if (pTrigger->index_slot >= 0)
+        SyncIndexRemove(pCounter, pTrigger, pTrigger->test_value);
+}
+
+/*  Make sure an indexed trigger can be refiled in any other slot of its
+ *  counter's index without allocating, so that a request changing its
+ *  test type fails before it changes anything.
+ */
+static int
+SyncIndexReserve(SyncTrigger * pTrigger)
+{
+    SyncCounter *pCounter = (SyncCounter *) pTrigger->pSync;
+    int slot;
+
+    if (!pCounter || SYNC_COUNTER != pCounter->sync.type ||
+        pTrigger->index_slot < 0)
+        return Success;
+
+    for (slot = 0; slot < SYNC_TRIGGER_INDEX_NUM; slot++) {
+        if (slot != pTrigger->index_slot &&
+            SyncIndexGrow(&pCounter->trigIndex[slot]) != Success)
+            return BadAlloc;
+    }
+    return Success;
+}
+
+/*  Refile a trigger after its test value or test type changed; oldvalue
+ *  is the test value it was filed under.  Does nothing for triggers that
+ *  are not currently in a counter's index.
+ */
+static void
+SyncIndexUpdateTrigger(SyncTrigger * pTrigger, int64_t oldvalue)
+{
+    SyncCounter *pCounter = (SyncCounter *) pTrigger->pSync;
+
+    if (!pCounter || SYNC_COUNTER != pCounter->sync.type ||
+        pTrigger->index_slot < 0)
+        return;
+
+    if (pTrigger->index_slot == SyncIndexSlot(pTrigger) &&
+        oldvalue == pTrigger->test_value)
+        return;
+
+    SyncIndexRemove(pCounter, pTrigger, oldvalue);
+
+    /* can't fail: either the trigger stays in the slot it was just
+     * removed from, or SyncIndexReserve() made room in the new one
+     */
+    SyncIndexAddTrigger(pCounter, pTrigger);
+}
+
+static void
+SyncIndexFree(SyncCounter * pCounter)
+{
+    int slot;
+
+    for (slot = 0; slot < SYNC_TRIGGER_INDEX_NUM; slot++) {
+        free(pCounter->trigIndex[slot].entries);
+        pCounter->trigIndex[slot].entries = NULL;
+        pCounter->trigIndex[slot].num = 0;
+        pCounter->trigIndex[slot].size = 0;
+    }
+}
+
 static int
 SyncInitTrigger(ClientPtr client, SyncTrigger * pTrigger, XID syncObject,
                 RESTYPE resType, Mask changes)
 {
     SyncObject *pSync = pTrigger->pSync;
     SyncCounter *pCounter = NULL;
+    int64_t oldvalue = pTrigger->test_value;
     int rc;
     Bool newSyncObject = FALSE;
 
@@ -360,6 +588,9 @@ SyncInitTrigger(ClientPtr client, SyncTrigger * pTrigger, XID syncObject,
 
     if (changes & XSyncCATestType) {
 
+        if ((rc = SyncIndexReserve(pTrigger)) != Success)
+            return rc;
+
         if (pSync && SYNC_FENCE == pSync->type) {
             pTrigger->CheckTrigger = SyncCheckTriggerFence;
         }
@@ -398,6 +629,7 @@ SyncInitTrigger(ClientPtr client, SyncTrigger * pTrigger, XID syncObject,
             overflow = checked_int64_add(&pTrigger->test_value,
                                          pCounter->value, pTrigger->wait_value);
             if (overflow) {
+                SyncIndexUpdateTrigger(pTrigger, oldvalue);
                 client->errorValue = pTrigger->wait_value >> 32;
                 return BadValue;
             }
@@ -411,8 +643,11 @@ SyncInitTrigger(ClientPtr client, SyncTrigger * pTrigger, XID syncObject,
         if ((rc = SyncAddTriggerToSyncObject(pTrigger)) != Success)
             return rc;
     }
-    else if (pCounter && IsSystemCounter(pCounter)) {
-        SyncComputeBracketValues(pCounter);
+    else {
+        SyncIndexUpdateTrigger(pTrigger, oldvalue);
+
+        if (pCounter && IsSystemCounter(pCounter))
+            SyncComputeBracketValues(pCounter);
     }
 
     return Success;
@@ -601,7 +836,12 @@ SyncAlarmTriggerFired(SyncTrigger * pTrigger)
      *  events, give the trigger its new test value.
      */
     SyncSendAlarmNotifyEvents(pAlarm);
-    pTrigger->test_value = new_test_value;
+    if (pTrigger->test_value != new_test_value) {
+        int64_t oldvalue = pTrigger->test_value;
+
+        pTrigger->test_value = new_test_value;
+        SyncIndexUpdateTrigger(pTrigger, oldvalue);
+    }
 }
 
 /*  This function is called when an Await unblocks, either as a result
@@ -713,18 +953,91 @@ SyncUpdateCounter(SyncCounter *pCounter, int64_t newval)
 void
 SyncChangeCounter(SyncCounter * pCounter, int64_t newval)
 {
-    SyncTriggerList *ptl, *pnext;
+    SyncTriggerIndex *pIndex = pCounter->trigIndex;
+    SyncTrigger *local[32];
+    SyncTriggerFiring firing;
     int64_t oldval;
+    int first[SYNC_TRIGGER_INDEX_NUM], last[SYNC_TRIGGER_INDEX_NUM];
+    int slot, num = 0;
 
     oldval = SyncUpdateCounter(pCounter, newval);
 
-    /* run through triggers to see if any become true */
-    for (ptl = pCounter->sync.pTriglist; ptl; ptl = pnext) {
-        pnext = ptl->next;
-        if ((*ptl->pTrigger->CheckTrigger) (ptl->pTrigger, oldval))
-            (*ptl->pTrigger->TriggerFired) (ptl->pTrigger);
+    /*  Only the triggers whose test value lies in the range covered by
+     *  the change can become true, and those form a contiguous run in
+     *  each slot of the index.
+     */
+    first[SYNC_TRIGGER_INDEX_POSITIVE_COMPARISON] = 0;
+    last[SYNC_TRIGGER_INDEX_POSITIVE_COMPARISON] =
+        SyncIndexUpperBound(&pIndex[SYNC_TRIGGER_INDEX_POSITIVE_COMPARISON],
+                            newval);
+    first[SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON] =
+        SyncIndexLowerBound(&pIndex[SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON],
+                            newval);
+    last[SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON] =
+        pIndex[SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON].num;
+    first[SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION] =
+        SyncIndexUpperBound(&pIndex[SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION],
+                            oldval);
+    last[SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION] =
+        SyncIndexUpperBound(&pIndex[SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION],
+                            newval);
+    first[SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION] =
+        SyncIndexLowerBound(&pIndex[SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION],
+                            newval);
+    last[SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION] =
+        SyncIndexLowerBound(&pIndex[SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION],
+                            oldval);
+
+    for (slot = 0; slot < SYNC_TRIGGER_INDEX_NUM; slot++) {
+        if (last[slot] > first[slot])
+            num += last[slot] - first[slot];
+    }
+
+    if (num) {
+        /*  Firing a trigger may refile or delete triggers in the index,
+         *  so run a snapshot of the candidates instead.
+         */
+        firing.triggers = local;
+        if (num > (int) ARRAY_SIZE(local)) {
+            firing.triggers = xallocarray(num, sizeof(SyncTrigger *));
+            if (!firing.triggers) {
+                SyncTriggerList *ptl, *pnext;
+
+                /* fall back to running through the whole list */
+                for (ptl = pCounter->sync.pTriglist; ptl; ptl = pnext) {
+                    pnext = ptl->next;
+                    if ((*ptl->pTrigger->CheckTrigger) (ptl->pTrigger, oldval))
+                        (*ptl->pTrigger->TriggerFired) (ptl->pTrigger);
+                }
+                goto brackets;
+            }
+        }
+
+        firing.num = 0;
+        for (slot = 0; slot < SYNC_TRIGGER_INDEX_NUM; slot++) {
+            int pos;
+
+            for (pos = first[slot]; pos < last[slot]; pos++)
+                firing.triggers[firing.num++] = pIndex[slot].entries[pos].pTrigger;
+        }
+
+        firing.next = pCounter->pFiring;
+        pCounter->pFiring = &firing;
+
+        /* run through triggers to see if any become true */
+        for (firing.cur = 0; firing.cur < firing.num; firing.cur++) {
+            SyncTrigger *pTrigger = firing.triggers[firing.cur];
+
+            if (pTrigger && (*pTrigger->CheckTrigger) (pTrigger, oldval))
+                (*pTrigger->TriggerFired) (pTrigger);
+        }
+
+        pCounter->pFiring = firing.next;
+        if (firing.triggers != local)
+            free(firing.triggers);
     }
 
+ brackets:
     if (IsSystemCounter(pCounter)) {
         SyncComputeBracketValues(pCounter);
     }
@@ -964,6 +1277,8 @@ SyncCreateCounter(ClientPtr client, XSyncCounter id, int64_t initialvalue)
 
     pCounter->value = initialvalue;
     pCounter->pSysCounterInfo = NULL;
+    memset(pCounter->trigIndex, 0, sizeof(pCounter->trigIndex));
+    pCounter->pFiring = NULL;
 
     pCounter->sync.initialized = TRUE;
 
@@ -1018,11 +1333,40 @@ SyncDestroySystemCounter(void *pSysCounter)
     FreeResource(pCounter->sync.id, X11_RESTYPE_NONE);
 }
 
+/*  Helpers for SyncComputeBracketValues: the closest test value in a
+ *  slot of the counter's trigger index that lies below (or above) the
+ *  counter value, optionally including the value itself.
+ */
+static void
+SyncBracketBelow(SyncTriggerIndex * pIndex, int64_t value, Bool inclusive,
+                 SysCounterInfo * psci, int64_t **ppnewltval)
+{
+    int pos = inclusive ? SyncIndexUpperBound(pIndex, value) :
+                          SyncIndexLowerBound(pIndex, value);
+
+    if (pos > 0 && pIndex->entries[pos - 1].value > psci->bracket_less) {
+        psci->bracket_less = pIndex->entries[pos - 1].value;
+        *ppnewltval = &psci->bracket_less;
+    }
+}
+
+static void
+SyncBracketAbove(SyncTriggerIndex * pIndex, int64_t value, Bool inclusive,
+                 SysCounterInfo * psci, int64_t **ppnewgtval)
+{
+    int pos = inclusive ? SyncIndexLowerBound(pIndex, value) :
+                          SyncIndexUpperBound(pIndex, value);
+
+    if (pos < pIndex->num && pIndex->entries[pos].value < psci->bracket_greater) {
+        psci->bracket_greater = pIndex->entries[pos].value;
+        *ppnewgtval = &psci->bracket_greater;
+    }
+}
+
 static void
 SyncComputeBracketValues(SyncCounter * pCounter)
 {
-    SyncTriggerList *pCur;
-    SyncTrigger *pTrigger;
+    SyncTriggerIndex *pIndex;
     SysCounterInfo *psci;
     int64_t *pnewgtval = NULL;
     int64_t *pnewltval = NULL;
@@ -1039,73 +1383,35 @@ SyncComputeBracketValues(SyncCounter * pCounter)
     psci->bracket_greater = LLONG_MAX;
     psci->bracket_less = LLONG_MIN;
 
-    for (pCur = pCounter->sync.pTriglist; pCur; pCur = pCur->next) {
-        pTrigger = pCur->pTrigger;
+    if (ct != XSyncCounterNeverIncreases) {
+        pIndex = &pCounter->trigIndex[SYNC_TRIGGER_INDEX_POSITIVE_COMPARISON];
+        SyncBracketAbove(pIndex, pCounter->value, FALSE, psci, &pnewgtval);
+        SyncBracketBelow(pIndex, pCounter->value, FALSE, psci, &pnewltval);
 
-        if (pTrigger->test_type == XSyncPositiveComparison &&
-            ct != XSyncCounterNeverIncreases) {
-            if (pCounter->value < pTrigger->test_value &&
-                pTrigger->test_value < psci->bracket_greater) {
-                psci->bracket_greater = pTrigger->test_value;
-                pnewgtval = &psci->bracket_greater;
-            }
-            else if (pCounter->value > pTrigger->test_value &&
-                     pTrigger->test_value > psci->bracket_less) {
-                    psci->bracket_less = pTrigger->test_value;
-                    pnewltval = &psci->bracket_less;
-            }
-        }
-        else if (pTrigger->test_type == XSyncNegativeComparison &&
-                 ct != XSyncCounterNeverDecreases) {
-            if (pCounter->value > pTrigger->test_value &&
-                pTrigger->test_value > psci->bracket_less) {
-                psci->bracket_less = pTrigger->test_value;
-                pnewltval = &psci->bracket_less;
-            }
-            else if (pCounter->value < pTrigger->test_value &&
-                     pTrigger->test_value < psci->bracket_greater) {
-                    psci->bracket_greater = pTrigger->test_value;
-                    pnewgtval = &psci->bracket_greater;
-            }
-        }
-        else if (pTrigger->test_type == XSyncNegativeTransition &&
-                 ct != XSyncCounterNeverIncreases) {
-            if (pCounter->value >= pTrigger->test_value &&
-                pTrigger->test_value > psci->bracket_less) {
-                    /*
-                     * If the value is exactly equal to our threshold, we want one
-                     * more event in the negative direction to ensure we pick up
-                     * when the value is less than this threshold.
-                     */
-                    psci->bracket_less = pTrigger->test_value;
-                    pnewltval = &psci->bracket_less;
-            }
-            else if (pCounter->value < pTrigger->test_value &&
-                     pTrigger->test_value < psci->bracket_greater) {
-                    psci->bracket_greater = pTrigger->test_value;
-                    pnewgtval = &psci->bracket_greater;
-            }
-        }
-        else if (pTrigger->test_type == XSyncPositiveTransition &&
-                 ct != XSyncCounterNeverDecreases) {
-            if (pCounter->value <= pTrigger->test_value &&
-                pTrigger->test_value < psci->bracket_greater) {
-                    /*
-                     * If the value is exactly equal to our threshold, we
-                     * want one more event in the positive direction to
-                     * ensure we pick up when the value *exceeds* this
-                     * threshold.
-                     */
-                    psci->bracket_greater = pTrigger->test_value;
-                    pnewgtval = &psci->bracket_greater;
-            }
-            else if (pCounter->value > pTrigger->test_value &&
-                     pTrigger->test_value > psci->bracket_less) {
-                    psci->bracket_less = pTrigger->test_value;
-                    pnewltval = &psci->bracket_less;
-            }
-        }
-    }                           /* end for each trigger */
+        /*
+         * If the value is exactly equal to a negative transition's
+         * threshold, we want one more event in the negative direction to
+         * ensure we pick up when the value is less than this threshold.
+         */
+        pIndex = &pCounter->trigIndex[SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION];
+        SyncBracketBelow(pIndex, pCounter->value, TRUE, psci, &pnewltval);
+        SyncBracketAbove(pIndex, pCounter->value, FALSE, psci, &pnewgtval);
+    }
+
+    if (ct != XSyncCounterNeverDecreases) {
+        pIndex = &pCounter->trigIndex[SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON];
+        SyncBracketBelow(pIndex, pCounter->value, FALSE, psci, &pnewltval);
+        SyncBracketAbove(pIndex, pCounter->value, FALSE, psci, &pnewgtval);
+
+        /*
+         * If the value is exactly equal to a positive transition's
+         * threshold, we want one more event in the positive direction to
+         * ensure we pick up when the value *exceeds* this threshold.
+         */
+        pIndex = &pCounter->trigIndex[SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION];
+        SyncBracketAbove(pIndex, pCounter->value, TRUE, psci, &pnewgtval);
+        SyncBracketBelow(pIndex, pCounter->value, FALSE, psci, &pnewltval);
+    }
 
     (*psci->BracketValues) ((void *) pCounter, pnewltval, pnewgtval);
 
@@ -1152,6 +1458,7 @@ FreeCounter(void *env, XID id)
 
         /* tell all the counter's triggers that counter has been destroyed */
         for (ptl = pCounter->sync.pTriglist; ptl; ptl = pnext) {
+            ptl->pTrigger->index_slot = -1;
             (*ptl->pTrigger->CounterDestroyed) (ptl->pTrigger);
             pnext = ptl->next;
             free(ptl); /* destroy the trigger list as we go */
@@ -1162,6 +1469,7 @@ FreeCounter(void *env, XID id)
             free(pCounter->pSysCounterInfo->private);
             free(pCounter->pSysCounterInfo);
         }
+        SyncIndexFree(pCounter);
     }
 
     free(pCounter);
@@ -1605,6 +1913,7 @@ ProcSyncAwait(ClientPtr client)
 
         /* sanity checks are in SyncInitTrigger */
         pAwait->trigger.pSync = NULL;
+        pAwait->trigger.index_slot = -1;
         pAwait->trigger.value_type = pProtocolWaitConds->value_type;
         pAwait->trigger.wait_value =
             ((int64_t)pProtocolWaitConds->wait_value_hi << 32) |
@@ -1709,6 +2018,7 @@ ProcSyncCreateAlarm(ClientPtr client)
 
     pTrigger = &pAlarm->trigger;
     pTrigger->pSync = NULL;
+    pTrigger->index_slot = -1;
     pTrigger->value_type = XSyncAbsolute;
     pTrigger->wait_value = 0;
     pTrigger->test_type = XSyncPositiveComparison;
@@ -2069,6 +2379,7 @@ ProcSyncAwaitFence(ClientPtr client)
         }
 
         pAwait->trigger.pSync = NULL;
+        pAwait->trigger.index_slot = -1;
         /* Provide acceptable values for these unused fields to
          * satisfy SyncInitTrigger's validation logic
          */
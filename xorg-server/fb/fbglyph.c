@@ -53,6 +53,84 @@ fbGlyphIn(RegionPtr pRegion, int x, int y, int width, int height)
     return RegionContainsRect(pRegion, &box) == rgnIN;
 }
 
+/*
+ * Check whether every glyph of a run can go through the per-depth glyph
+ * routines: each must fit in one stipple word, and the extents of the run
+ * must lie within the clip.  Testing the run once saves a region test per
+ * glyph for the usual case of unobscured text.
+ */
+static Bool
+fbGlyphRunIn(RegionPtr pRegion, int x, int y,
+             unsigned int nglyph, CharInfoPtr * ppci)
+{
+    CharInfoPtr pci;
+    int gx, gy;
+    int gWidth, gHeight;
+    int x1 = INT_MAX, y1 = INT_MAX, x2 = INT_MIN, y2 = INT_MIN;
+
+    while (nglyph--) {
+        pci = *ppci++;
+        gWidth = GLYPHWIDTHPIXELS(pci);
+        gHeight = GLYPHHEIGHTPIXELS(pci);
+        if (gWidth && gHeight) {
+            if (gWidth > sizeof(FbStip) * 8)
+                return FALSE;
+            gx = x + pci->metrics.leftSideBearing;
+            gy = y - pci->metrics.ascent;
+            if (gx < x1)
+                x1 = gx;
+            if (gx + gWidth > x2)
+                x2 = gx + gWidth;
+            if (gy < y1)
+                y1 = gy;
+            if (gy + gHeight > y2)
+                y2 = gy + gHeight;
+        }
+        x += pci->metrics.characterWidth;
+    }
+    if (x1 > x2)
+        return TRUE;
+    return fbGlyphIn(pRegion, x1, y1, x2 - x1, y2 - y1);
+}
+
+/*
+ * Draw a run of glyphs which fbGlyphRunIn accepted, with a single access
+ * to the destination.
+ */
+static void
+fbGlyphRun(DrawablePtr pDrawable,
+           void (*glyph) (FbBits *, FbStride, int, FbStip *, FbBits, int, int),
+           FbBits fg,
+           int x,
+           int y,
+           unsigned int nglyph, CharInfoPtr * ppci, void *pglyphBase)
+{
+    CharInfoPtr pci;
+    unsigned char *pglyph;
+    int gx, gy;
+    int gWidth, gHeight;
+    FbBits *dst;
+    FbStride dstStride;
+    int dstBpp;
+    int dstXoff, dstYoff;
+
+    fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff, dstYoff);
+    while (nglyph--) {
+        pci = *ppci++;
+        pglyph = FONTGLYPHBITS(pglyphBase, pci);
+        gWidth = GLYPHWIDTHPIXELS(pci);
+        gHeight = GLYPHHEIGHTPIXELS(pci);
+        if (gWidth && gHeight) {
+            gx = x + pci->metrics.leftSideBearing;
+            gy = y - pci->metrics.ascent;
+            (*glyph) (dst + (gy + dstYoff) * dstStride, dstStride, dstBpp,
+                      (FbStip *) pglyph, fg, gx + dstXoff, gHeight);
+        }
+        x += pci->metrics.characterWidth;
+    }
+    fbFinishAccess(pDrawable);
+}
+
 void
 fbPolyGlyphBlt(DrawablePtr pDrawable,
                GCPtr pGC,
@@ -90,6 +168,13 @@ fbPolyGlyphBlt(DrawablePtr pDrawable,
     x += pDrawable->x;
     y += pDrawable->y;
 
+    if (glyph &&
+        fbGlyphRunIn(fbGetCompositeClip(pGC), x, y, nglyph, ppci)) {
+        fbGlyphRun(pDrawable, glyph, pPriv->xor, x, y, nglyph, ppci,
+                   pglyphBase);
+        return;
+    }
+
     while (nglyph--) {
         pci = *ppci++;
         pglyph = FONTGLYPHBITS(pglyphBase, pci);
@@ -191,6 +276,13 @@ fbImageGlyphBlt(DrawablePtr pDrawable,
         opaque = FALSE;
     }
 
+    if (glyph &&
+        fbGlyphRunIn(fbGetCompositeClip(pGC), x, y, nglyph, ppciInit)) {
+        fbGlyphRun(pDrawable, glyph, pPriv->fg, x, y, nglyph, ppciInit,
+                   pglyphBase);
+        return;
+    }
+
     ppci = ppciInit;
     while (nglyph--) {
         pci = *ppci++;
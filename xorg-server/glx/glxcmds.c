@@ -2074,6 +2074,9 @@ ResetLargeCommandStatus(__GLXcontext *cx)
     cx->largeCmdRequestsTotal = 0;
 }
 
+/* Number of decoded render opcodes __glXDisp_Render remembers. */
+#define RENDER_DECODE_CACHE_SIZE 32
+
 /*
 ** Execute all the drawing commands in a request.
 */
@@ -2088,6 +2091,19 @@ __glXDisp_Render(__GLXclientState * cl, GLbyte * pc)
     __GLXrenderHeader *hdr;
     __GLXcontext *glxc;
 
+    /*
+    ** Immediate mode streams repeat a handful of opcodes (Color, Normal,
+    ** Vertex, ...), so remember the size data and decode function of the
+    ** recently seen ones instead of walking the dispatch tree twice for
+    ** every command.
+    */
+    struct {
+        int opcode;
+        __GLXrenderSizeData entry;
+        __GLXdispatchRenderProcPtr proc;
+    } decoded[RENDER_DECODE_CACHE_SIZE];
+    int i;
+
     __GLX_DECLARE_SWAP_VARIABLES;
 
     REQUEST_AT_LEAST_SIZE(xGLXRenderReq);
@@ -2103,6 +2119,9 @@ __glXDisp_Render(__GLXclientState * cl, GLbyte * pc)
         return error;
     }
 
+    for (i = 0; i < RENDER_DECODE_CACHE_SIZE; i++)
+        decoded[i].opcode = -1;
+
     commandsDone = 0;
     pc += sz_xGLXRenderReq;
     left = (req->length << 2) - sz_xGLXRenderReq;
@@ -2110,7 +2129,6 @@ __glXDisp_Render(__GLXclientState * cl, GLbyte * pc)
         __GLXrenderSizeData entry;
         int extra = 0;
         __GLXdispatchRenderProcPtr proc;
-        int err;
 
         if (left < sizeof(__GLXrenderHeader))
             return BadLength;
@@ -2133,14 +2151,28 @@ __glXDisp_Render(__GLXclientState * cl, GLbyte * pc)
         /*
          ** Check for core opcodes and grab entry data.
          */
-        err = __glXGetProtocolSizeData(&Render_dispatch_info, opcode, &entry);
-        proc = (__GLXdispatchRenderProcPtr)
-            __glXGetProtocolDecodeFunction(&Render_dispatch_info,
-                                           opcode, client->swapped);
+        i = opcode % RENDER_DECODE_CACHE_SIZE;
+        if (decoded[i].opcode == opcode) {
+            entry = decoded[i].entry;
+            proc = decoded[i].proc;
+        }
+        else {
+            int err;
+
+            err = __glXGetProtocolSizeData(&Render_dispatch_info, opcode,
+                                           &entry);
+            proc = (__GLXdispatchRenderProcPtr)
+                __glXGetProtocolDecodeFunction(&Render_dispatch_info,
+                                               opcode, client->swapped);
+
+            if ((err < 0) || (proc == NULL)) {
+                client->errorValue = commandsDone;
+                return __glXError(GLXBadRenderRequest);
+            }
 
-        if ((err < 0) || (proc == NULL)) {
-            client->errorValue = commandsDone;
-            return __glXError(GLXBadRenderRequest);
+            decoded[i].opcode = opcode;
+            decoded[i].entry = entry;
+            decoded[i].proc = proc;
         }
 
         if (cmdlen < entry.bytes) {
@@ -47,10 +47,32 @@ struct _SyncObject {
     Bool beingDestroyed;        /* in process of going away */
 };
 
+/* Counter triggers are additionally kept sorted by test value, one array
+ * per test type, so a counter change only visits the triggers it fires.
+ */
+#define SYNC_TRIGGER_INDEX_POSITIVE_TRANSITION  0
+#define SYNC_TRIGGER_INDEX_NEGATIVE_TRANSITION  1
+#define SYNC_TRIGGER_INDEX_POSITIVE_COMPARISON  2
+#define SYNC_TRIGGER_INDEX_NEGATIVE_COMPARISON  3
+#define SYNC_TRIGGER_INDEX_NUM                  4
+
+typedef struct _SyncTriggerIndexEntry {
+    int64_t value;              /* test value the trigger was filed under */
+    struct _SyncTrigger *pTrigger;
+} SyncTriggerIndexEntry;
+
+typedef struct _SyncTriggerIndex {
+    SyncTriggerIndexEntry *entries;
+    int num;
+    int size;
+} SyncTriggerIndex;
+
 typedef struct _SyncCounter {
     SyncObject sync;            /* Common sync object data */
     int64_t value;              /* counter value */
     struct _SysCounterInfo *pSysCounterInfo; /* NULL if not a system counter */
+    SyncTriggerIndex trigIndex[SYNC_TRIGGER_INDEX_NUM];
+    struct _SyncTriggerFiring *pFiring; /* triggers being fired, if any */
 } SyncCounter;
 
 struct _SyncFence {
@@ -71,6 +93,7 @@ struct _SyncTrigger {
                          int64_t newval);
     void (*TriggerFired)(struct _SyncTrigger *pTrigger);
     void (*CounterDestroyed)(struct _SyncTrigger *pTrigger);
+    int index_slot;             /* slot in the counter's trigger index, or -1 */
 };
 
 typedef struct _SyncTriggerList {
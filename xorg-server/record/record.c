@@ -62,9 +62,11 @@ and Jim Haggerty of Metheus.
 static RESTYPE RTContext;       /* internal resource type for Record contexts */
 
 /* How many bytes of protocol data to buffer in a context. Don't set to less
- * than 32.
+ * than 32.  Recorded protocol accumulates here, possibly as several replies
+ * back to back, until the buffer fills or the server blocks; large values
+ * keep busy clients from generating a tiny write per request.
  */
-#define REPLY_BUF_SIZE 1024
+#define REPLY_BUF_SIZE 32768
 
 /* Record Context structure */
 
@@ -77,8 +79,17 @@ typedef struct {
     char elemHeaders;           /* element header flags (time/seq no.) */
     char bufCategory;           /* category of protocol in replyBuffer */
     int numBufBytes;            /* number of bytes in replyBuffer */
+    int bufReplyStart;          /* offset of the reply being filled */
     char replyBuffer[REPLY_BUF_SIZE];   /* buffered recorded protocol */
     int inFlush;                /*  are we inside RecordFlushReplyBuffer */
+    int elemBytesLeft;          /* bytes still to come of the element
+                                 * last recorded in replyBuffer */
+    char *overflow;             /* protocol recorded while flushing */
+    int numOverflowBytes;       /* number of bytes in overflow */
+    int overflowSize;           /* bytes allocated for overflow */
+    int overflowElemStart;      /* offset of the element being recorded
+                                 * in overflow, or -1 */
+    int overflowBytesLeft;      /* bytes still to come of that element */
 } RecordContextRec, *RecordContextPtr;
 
 /*  RecordMinorOpRec - to hold minor opcode selections for extension requests
@@ -228,7 +239,9 @@ RecordFindContextOnAllContexts(RecordContextPtr pContext)
  *	to the recording client, and the number of buffered bytes is set to
  *	zero.  If len1 is not zero, data1/len1 are then written to the
  *	recording client, and similarly for data2/len2 (written after
- *	data1/len1).
+ *	data1/len1).  Protocol recorded while these writes were in progress
+ *	was put in the overflow buffer; it is written last, unless the
+ *	protocol element in the context's buffer is not complete yet.
  */
 static void
 RecordFlushReplyBuffer(RecordContextPtr pContext,
@@ -242,13 +255,246 @@ RecordFlushReplyBuffer(RecordContextPtr pContext,
         WriteToClient(pContext->pRecordingClient, pContext->numBufBytes,
                       pContext->replyBuffer);
     pContext->numBufBytes = 0;
+    pContext->bufReplyStart = 0;
     if (len1)
         WriteToClient(pContext->pRecordingClient, len1, data1);
     if (len2)
         WriteToClient(pContext->pRecordingClient, len2, data2);
+    if (pContext->numOverflowBytes && !pContext->elemBytesLeft &&
+        !pContext->overflowBytesLeft) {
+        char *overflow = pContext->overflow;
+        int len = pContext->numOverflowBytes;
+
+        /* anything recorded while this is written starts a new one */
+        pContext->overflow = NULL;
+        pContext->numOverflowBytes = pContext->overflowSize = 0;
+        WriteToClient(pContext->pRecordingClient, len, overflow);
+        free(overflow);
+    }
     --pContext->inFlush;
 }                               /* RecordFlushReplyBuffer */
 
+/* RecordFillReplyHeader
+ *
+ * Arguments:
+ *	pContext is the context that is recording a protocol element.
+ *	pRep is the reply to fill in.
+ *	pClient and category are as for RecordAProtocolElement.
+ *	serverTime is the current server time.
+ *
+ * Returns: nothing.
+ *
+ * Side Effects:
+ *	The header of an empty reply carrying protocol of pClient and
+ *	category is stored at pRep.
+ */
+static void
+RecordFillReplyHeader(RecordContextPtr pContext,
+                      xRecordEnableContextReply * pRep, ClientPtr pClient,
+                      int category, CARD32 serverTime)
+{
+    Bool recordingClientSwapped = pContext->pRecordingClient->swapped;
+
+    pRep->type = X_Reply;
+    pRep->category = category;
+    pRep->sequenceNumber = pContext->pRecordingClient->sequence;
+    pRep->length = 0;
+    pRep->elementHeader = pContext->elemHeaders;
+    pRep->serverTime = serverTime;
+    if (pClient) {
+        pRep->clientSwapped = (pClient->swapped != recordingClientSwapped);
+        pRep->idBase = pClient->clientAsMask;
+        pRep->recordedSequenceNumber = pClient->sequence;
+    }
+    else {                      /* it's a device event, StartOfData, or EndOfData */
+
+        pRep->clientSwapped = (category != XRecordFromServer) &&
+            recordingClientSwapped;
+        pRep->idBase = 0;
+        pRep->recordedSequenceNumber = 0;
+    }
+
+    if (recordingClientSwapped) {
+        swaps(&pRep->sequenceNumber);
+        swapl(&pRep->length);
+        swapl(&pRep->idBase);
+        swapl(&pRep->serverTime);
+        swapl(&pRep->recordedSequenceNumber);
+    }
+}                               /* RecordFillReplyHeader */
+
+/* RecordElementHeaders
+ *
+ * Arguments:
+ *	pContext, pClient and category are as for RecordAProtocolElement.
+ *	gotServerTime tells whether serverTime holds the current server time.
+ *	elemHeaderData is where to store the element headers.
+ *
+ * Returns: the length in bytes of the element headers stored.
+ *
+ * Side Effects:
+ *	The element headers (time and sequence number) that the context
+ *	wants for a new protocol element are stored in elemHeaderData.
+ */
+static int
+RecordElementHeaders(RecordContextPtr pContext, ClientPtr pClient,
+                     int category, Bool gotServerTime, CARD32 serverTime,
+                     CARD32 *elemHeaderData)
+{
+    Bool recordingClientSwapped = pContext->pRecordingClient->swapped;
+    int numElemHeaders = 0;
+
+    if (((pContext->elemHeaders & XRecordFromClientTime)
+         && category == XRecordFromClient)
+        || ((pContext->elemHeaders & XRecordFromServerTime)
+            && category == XRecordFromServer)) {
+        if (gotServerTime)
+            elemHeaderData[numElemHeaders] = serverTime;
+        else
+            elemHeaderData[numElemHeaders] = GetTimeInMillis();
+        if (recordingClientSwapped)
+            swapl(&elemHeaderData[numElemHeaders]);
+        numElemHeaders++;
+    }
+
+    if ((pContext->elemHeaders & XRecordFromClientSequence)
+        && (category == XRecordFromClient || category == XRecordClientDied)) {
+        elemHeaderData[numElemHeaders] = pClient->sequence;
+        if (recordingClientSwapped)
+            swapl(&elemHeaderData[numElemHeaders]);
+        numElemHeaders++;
+    }
+
+    return numElemHeaders * 4;
+}                               /* RecordElementHeaders */
+
+/* RecordAddReplyLength
+ *
+ * Arguments:
+ *	pContext is the context that is recording a protocol element.
+ *	pRep is a reply being filled.
+ *	len is the number of 4-byte units being added to the reply.
+ *
+ * Returns: nothing.
+ *
+ * Side Effects:
+ *	The length of the reply is increased by len.
+ */
+static void
+RecordAddReplyLength(RecordContextPtr pContext,
+                     xRecordEnableContextReply * pRep, int len)
+{
+    Bool recordingClientSwapped = pContext->pRecordingClient->swapped;
+    CARD32 replylen;
+
+    replylen = pRep->length;
+    if (recordingClientSwapped)
+        swapl(&replylen);
+    replylen += len;
+    if (recordingClientSwapped)
+        swapl(&replylen);
+    pRep->length = replylen;
+}                               /* RecordAddReplyLength */
+
+/* RecordCopyElementData
+ *
+ * Arguments:
+ *	dst is where to copy the data to.
+ *	elemHeaderData/numElemHeaders are the element headers and their
+ *	  length in bytes.
+ *	data/datalen/padlen are as for RecordAProtocolElement.
+ *
+ * Returns: the number of bytes copied, numElemHeaders + datalen.
+ */
+static int
+RecordCopyElementData(char *dst, CARD32 *elemHeaderData, int numElemHeaders,
+                      void *data, int datalen, int padlen)
+{
+    static char padBuffer[3];   /* as in FlushClient */
+
+    if (numElemHeaders)
+        memcpy(dst, elemHeaderData, numElemHeaders);
+    if (datalen) {
+        memcpy(dst + numElemHeaders, data, datalen - padlen);
+        memcpy(dst + numElemHeaders + datalen - padlen, padBuffer, padlen);
+    }
+    return numElemHeaders + datalen;
+}                               /* RecordCopyElementData */
+
+/* RecordOverflowElement
+ *
+ * Arguments: as for RecordAProtocolElement.
+ *
+ * Returns: nothing.
+ *
+ * Side Effects:
+ *	The protocol element, recorded while the context is being flushed,
+ *	is appended to the context's overflow buffer, which the flush
+ *	writes to the recording client when it is done.  Every element
+ *	gets a reply of its own there, which its continuation data follows.
+ *	If the overflow buffer can't be grown, the element is dropped
+ *	along with its continuation data.
+ */
+static void
+RecordOverflowElement(RecordContextPtr pContext, ClientPtr pClient,
+                      int category, void *data, int datalen, int padlen,
+                      int futurelen)
+{
+    CARD32 elemHeaderData[2];
+    int numElemHeaders = 0;
+    int len;
+
+    if (futurelen >= 0) {
+        pContext->overflowElemStart = pContext->numOverflowBytes;
+        pContext->overflowBytesLeft = futurelen;
+        numElemHeaders = RecordElementHeaders(pContext, pClient, category,
+                                              FALSE, 0, elemHeaderData);
+        len = SIZEOF(xRecordEnableContextReply) + numElemHeaders + datalen;
+    }
+    else {
+        pContext->overflowBytesLeft -= datalen;
+        if (pContext->overflowBytesLeft < 0)
+            pContext->overflowBytesLeft = 0;
+        len = datalen;
+    }
+    if (pContext->overflowElemStart < 0)
+        return;                 /* the element was dropped */
+
+    if (pContext->overflowSize - pContext->numOverflowBytes < len) {
+        int size = max(2 * pContext->overflowSize,
+                       pContext->numOverflowBytes + len);
+        char *overflow = realloc(pContext->overflow, size);
+
+        if (!overflow) {
+            pContext->numOverflowBytes = pContext->overflowElemStart;
+            pContext->overflowElemStart = -1;
+            return;
+        }
+        pContext->overflow = overflow;
+        pContext->overflowSize = size;
+    }
+
+    if (futurelen >= 0) {
+        xRecordEnableContextReply *pRep = (xRecordEnableContextReply *)
+            (pContext->overflow + pContext->numOverflowBytes);
+
+        RecordFillReplyHeader(pContext, pRep, pClient, category,
+                              GetTimeInMillis());
+        RecordAddReplyLength(pContext, pRep,
+                             bytes_to_int32(numElemHeaders) +
+                             bytes_to_int32(datalen) +
+                             bytes_to_int32(futurelen));
+        pContext->numOverflowBytes += SIZEOF(xRecordEnableContextReply);
+    }
+    pContext->numOverflowBytes +=
+        RecordCopyElementData(pContext->overflow + pContext->numOverflowBytes,
+                              elemHeaderData, numElemHeaders,
+                              data, datalen, padlen);
+
+    if (!pContext->overflowBytesLeft)
+        pContext->overflowElemStart = -1;
+}                               /* RecordOverflowElement */
+
 /* RecordAProtocolElement
  *
  * Arguments:
@@ -273,9 +519,12 @@ RecordFlushReplyBuffer(RecordContextPtr pContext,
  *	added to the context's protocol buffer with appropriate element
  *	headers prepended (sequence number and timestamp).  If the data
  *	is continuation data (futurelen == -1), element headers won't
- *	be added.  If the protocol element and headers won't fit in
- *	the context's buffer, it is sent directly to the recording
- *	client (after any buffered data).
+ *	be added.  Protocol of a different client or category starts a
+ *	new reply behind the ones already buffered.  If the protocol
+ *	element and headers won't fit in the context's buffer, it is
+ *	sent directly to the recording client (after any buffered data).
+ *	Protocol recorded while the context is being flushed goes to
+ *	the overflow buffer instead; see RecordOverflowElement.
  */
 static void
 RecordAProtocolElement(RecordContextPtr pContext, ClientPtr pClient,
@@ -284,110 +533,81 @@ RecordAProtocolElement(RecordContextPtr pContext, ClientPtr pClient,
 {
     CARD32 elemHeaderData[2];
     int numElemHeaders = 0;
-    Bool recordingClientSwapped = pContext->pRecordingClient->swapped;
     CARD32 serverTime = 0;
     Bool gotServerTime = FALSE;
-    int replylen;
+
+    /* continuation data follows the element it belongs to */
+    if (futurelen >= 0 ? pContext->inFlush :
+        pContext->overflowBytesLeft > 0 || pContext->inFlush) {
+        RecordOverflowElement(pContext, pClient, category, data, datalen,
+                              padlen, futurelen);
+        return;
+    }
 
     if (futurelen >= 0) {       /* start of new protocol element */
-        xRecordEnableContextReply *pRep = (xRecordEnableContextReply *)
-            pContext->replyBuffer;
+        xRecordEnableContextReply *pRep;
+
+        pContext->elemBytesLeft = futurelen;
 
         if (pContext->pBufClient != pClient ||
             pContext->bufCategory != category) {
-            RecordFlushReplyBuffer(pContext, NULL, 0, NULL, 0);
+            /* append a new reply unless its header and this element
+             * (with the largest possible element headers) won't fit
+             */
+            if (REPLY_BUF_SIZE - pContext->numBufBytes <
+                SIZEOF(xRecordEnableContextReply) + 8 + datalen)
+                RecordFlushReplyBuffer(pContext, NULL, 0, NULL, 0);
+            /* the flush does nothing once the recording client is gone */
+            if (REPLY_BUF_SIZE - pContext->numBufBytes <
+                SIZEOF(xRecordEnableContextReply))
+                return;
+            pContext->bufReplyStart = pContext->numBufBytes;
             pContext->pBufClient = pClient;
             pContext->bufCategory = category;
         }
 
-        if (!pContext->numBufBytes) {
+        pRep = (xRecordEnableContextReply *)
+            (pContext->replyBuffer + pContext->bufReplyStart);
+
+        if (pContext->numBufBytes == pContext->bufReplyStart) {
             serverTime = GetTimeInMillis();
             gotServerTime = TRUE;
-            pRep->type = X_Reply;
-            pRep->category = category;
-            pRep->sequenceNumber = pContext->pRecordingClient->sequence;
-            pRep->length = 0;
-            pRep->elementHeader = pContext->elemHeaders;
-            pRep->serverTime = serverTime;
-            if (pClient) {
-                pRep->clientSwapped =
-                    (pClient->swapped != recordingClientSwapped);
-                pRep->idBase = pClient->clientAsMask;
-                pRep->recordedSequenceNumber = pClient->sequence;
-            }
-            else {              /* it's a device event, StartOfData, or EndOfData */
-
-                pRep->clientSwapped = (category != XRecordFromServer) &&
-                    recordingClientSwapped;
-                pRep->idBase = 0;
-                pRep->recordedSequenceNumber = 0;
-            }
-
-            if (recordingClientSwapped) {
-                swaps(&pRep->sequenceNumber);
-                swapl(&pRep->length);
-                swapl(&pRep->idBase);
-                swapl(&pRep->serverTime);
-                swapl(&pRep->recordedSequenceNumber);
-            }
-            pContext->numBufBytes = SIZEOF(xRecordEnableContextReply);
+            RecordFillReplyHeader(pContext, pRep, pClient, category,
+                                  serverTime);
+            pContext->numBufBytes += SIZEOF(xRecordEnableContextReply);
         }
 
         /* generate element headers if needed */
 
-        if (((pContext->elemHeaders & XRecordFromClientTime)
-             && category == XRecordFromClient)
-            || ((pContext->elemHeaders & XRecordFromServerTime)
-                && category == XRecordFromServer)) {
-            if (gotServerTime)
-                elemHeaderData[numElemHeaders] = serverTime;
-            else
-                elemHeaderData[numElemHeaders] = GetTimeInMillis();
-            if (recordingClientSwapped)
-                swapl(&elemHeaderData[numElemHeaders]);
-            numElemHeaders++;
-        }
-
-        if ((pContext->elemHeaders & XRecordFromClientSequence)
-            && (category == XRecordFromClient || category == XRecordClientDied)) {
-            elemHeaderData[numElemHeaders] = pClient->sequence;
-            if (recordingClientSwapped)
-                swapl(&elemHeaderData[numElemHeaders]);
-            numElemHeaders++;
-        }
+        numElemHeaders = RecordElementHeaders(pContext, pClient, category,
+                                              gotServerTime, serverTime,
+                                              elemHeaderData);
 
         /* adjust reply length */
 
-        replylen = pRep->length;
-        if (recordingClientSwapped)
-            swapl(&replylen);
-        replylen += numElemHeaders + bytes_to_int32(datalen) +
-            bytes_to_int32(futurelen);
-        if (recordingClientSwapped)
-            swapl(&replylen);
-        pRep->length = replylen;
+        RecordAddReplyLength(pContext, pRep,
+                             bytes_to_int32(numElemHeaders) +
+                             bytes_to_int32(datalen) +
+                             bytes_to_int32(futurelen));
     }                           /* end if not continued reply */
-
-    numElemHeaders *= 4;
+    else {
+        pContext->elemBytesLeft -= datalen;
+        if (pContext->elemBytesLeft < 0)
+            pContext->elemBytesLeft = 0;
+    }
 
     /* if space available >= space needed, buffer the data */
 
     if (REPLY_BUF_SIZE - pContext->numBufBytes >= datalen + numElemHeaders) {
-        if (numElemHeaders) {
-            memcpy(pContext->replyBuffer + pContext->numBufBytes,
-                   elemHeaderData, numElemHeaders);
-            pContext->numBufBytes += numElemHeaders;
-        }
-        if (datalen) {
-            static char padBuffer[3];   /* as in FlushClient */
-
-            memcpy(pContext->replyBuffer + pContext->numBufBytes,
-                   data, datalen - padlen);
-            pContext->numBufBytes += datalen - padlen;
-            memcpy(pContext->replyBuffer + pContext->numBufBytes,
-                   padBuffer, padlen);
-            pContext->numBufBytes += padlen;
-        }
+        pContext->numBufBytes +=
+            RecordCopyElementData(pContext->replyBuffer +
+                                  pContext->numBufBytes,
+                                  elemHeaderData, numElemHeaders,
+                                  data, datalen, padlen);
+
+        /* protocol recorded by an earlier flush can follow now */
+        if (pContext->numOverflowBytes && !pContext->elemBytesLeft)
+            RecordFlushReplyBuffer(pContext, NULL, 0, NULL, 0);
     }
     else {
         RecordFlushReplyBuffer(pContext, (void *) elemHeaderData,
@@ -801,18 +1021,19 @@ RecordADeviceEvent(CallbackListPtr *pcbl, void *nulldata, void *calldata)
 /* RecordFlushAllContexts
  *
  * Arguments:
- *	pcbl is &FlushCallback.
- *	nulldata and calldata are NULL.
+ *	blockData and timeout are unused; this is a block handler.
  *
  * Returns: nothing.
  *
  * Side Effects:
  *	All buffered reply data of all enabled contexts is written to
- *	the recording clients.
+ *	the recording clients.  Running this only when the server is
+ *	about to block, rather than from FlushCallback on every client
+ *	flush, lets protocol from many requests and clients go out in one
+ *	write.  The output is flushed right after the block handlers run.
  */
 static void
-RecordFlushAllContexts(CallbackListPtr *pcbl,
-                       void *nulldata, void *calldata)
+RecordFlushAllContexts(void *blockData, void *timeout)
 {
     int eci;                    /* enabled context index */
     RecordContextPtr pContext;
@@ -825,8 +1046,13 @@ RecordFlushAllContexts(CallbackListPtr *pcbl,
          * check before calling hoping to save the function call cost
          * most of the time.
          */
-        if (pContext->numBufBytes)
+        if (pContext->numBufBytes || pContext->numOverflowBytes) {
+            /* no protocol element is recorded across a block */
+            pContext->elemBytesLeft = 0;
+            pContext->overflowBytesLeft = 0;
+            pContext->overflowElemStart = -1;
             RecordFlushReplyBuffer(ppAllContexts[eci], NULL, 0, NULL, 0);
+        }
     }
 }                               /* RecordFlushAllContexts */
 
@@ -905,12 +1131,10 @@ RecordInstallHooks(RecordClientsAndProtocolPtr pRCAP, XID oneclient)
             return BadAlloc;
         if (!AddCallback(&ReplyCallback, RecordAReply, NULL))
             return BadAlloc;
-        if (!AddCallback(&FlushCallback, RecordFlushAllContexts, NULL))
+        if (!RegisterBlockAndWakeupHandlers(RecordFlushAllContexts,
+                                            (ServerWakeupHandlerProcPtr)
+                                            NoopDDA, NULL))
             return BadAlloc;
-        /* Alternate context flushing scheme: delete the line above
-         * and call RegisterBlockAndWakeupHandlers here passing
-         * RecordFlushAllContexts.  Is this any better?
-         */
     }
     return Success;
 }                               /* RecordInstallHooks */
@@ -1000,13 +1224,11 @@ RecordUninstallHooks(RecordClientsAndProtocolPtr pRCAP, XID oneclient)
         DeleteCallback(&EventCallback, RecordADeliveredEventOrError, NULL);
         DeleteCallback(&DeviceEventCallback, RecordADeviceEvent, NULL);
         DeleteCallback(&ReplyCallback, RecordAReply, NULL);
-        DeleteCallback(&FlushCallback, RecordFlushAllContexts, NULL);
-        /* Alternate context flushing scheme: delete the line above
-         * and call RemoveBlockAndWakeupHandlers here passing
-         * RecordFlushAllContexts.  Is this any better?
-         */
-        /* Having deleted the callback, call it one last time. -gildea */
-        RecordFlushAllContexts(&FlushCallback, NULL, NULL);
+        RemoveBlockAndWakeupHandlers(RecordFlushAllContexts,
+                                     (ServerWakeupHandlerProcPtr) NoopDDA,
+                                     NULL);
+        /* Having removed the handler, call it one last time. -gildea */
+        RecordFlushAllContexts(NULL, NULL);
     }
 }                               /* RecordUninstallHooks */
 
@@ -1864,9 +2086,16 @@ ProcRecordCreateContext(ClientPtr client)
     pContext->elemHeaders = 0;
     pContext->bufCategory = 0;
     pContext->numBufBytes = 0;
+    pContext->bufReplyStart = 0;
     pContext->pBufClient = NULL;
     pContext->continuedReply = 0;
     pContext->inFlush = 0;
+    pContext->elemBytesLeft = 0;
+    pContext->overflow = NULL;
+    pContext->numOverflowBytes = 0;
+    pContext->overflowSize = 0;
+    pContext->overflowElemStart = -1;
+    pContext->overflowBytesLeft = 0;
 
     err = RecordRegisterClients(pContext, client,
                                 (xRecordRegisterClientsReq *) stuff);
@@ -2363,6 +2592,11 @@ RecordDisableContext(RecordContextPtr pContext)
         RecordAProtocolElement(pContext, NULL, XRecordEndOfData, NULL, 0, 0, 0);
         RecordFlushReplyBuffer(pContext, NULL, 0, NULL, 0);
     }
+    free(pContext->overflow);
+    pContext->overflow = NULL;
+    pContext->numOverflowBytes = pContext->overflowSize = 0;
+    pContext->overflowElemStart = -1;
+    pContext->overflowBytesLeft = 0;
     /* Re-enable request processing on this connection. */
     AttendClient(pContext->pRecordingClient);
 
@@ -2752,6 +2986,11 @@ RecordAClientStateChange(CallbackListPtr *pcbl, void *nulldata,
                                            XRecordClientDied, NULL, 0, 0, 0);
                 RecordDeleteClientFromRCAP(pRCAP, pos);
             }
+            /* pClient may be reused; don't append to its buffered reply */
+            if (pContext->pBufClient == pClient) {
+                pContext->pBufClient = NULL;
+                pContext->bufCategory = -1;
+            }
         }
 
         free(ppAllContextsCopy);
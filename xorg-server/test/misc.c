@@ -221,6 +221,25 @@ bswap_test(void)
     result_64 = test_64;
     swapll(&result_64);
     assert(result_64 == expect_64);
+
+    /* odd lengths to cover the unrolled loops and their tails */
+    {
+        CARD32 longs[11];
+        short shorts[19];
+        int i;
+
+        for (i = 0; i < ARRAY_SIZE(longs); i++)
+            longs[i] = test_32 + i;
+        SwapLongs(longs, ARRAY_SIZE(longs));
+        for (i = 0; i < ARRAY_SIZE(longs); i++)
+            assert(longs[i] == bswap_32(test_32 + i));
+
+        for (i = 0; i < ARRAY_SIZE(shorts); i++)
+            shorts[i] = test_16 + i;
+        SwapShorts(shorts, ARRAY_SIZE(shorts));
+        for (i = 0; i < ARRAY_SIZE(shorts); i++)
+            assert((uint16_t) shorts[i] == bswap_16(test_16 + i));
+    }
 }
 
 const testfunc_t*
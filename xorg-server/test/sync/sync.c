@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <time.h>
 #include <xcb/sync.h>
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
@@ -281,6 +282,67 @@ test_change_alarm_delta(xcb_connection_t *c)
     }
 }
 
+/* Creates many alarms on one counter and steps the counter through
+ * their thresholds, checking that exactly the alarms crossed by each
+ * step fire.  Also reports how long the steps took.
+ */
+static void
+test_many_alarms(xcb_connection_t *c, uint8_t first_event)
+{
+    const int num_alarms = 10000, num_steps = 10;
+    xcb_sync_counter_t counter = xcb_generate_id(c);
+    struct timespec start, end;
+    int fired = 0;
+
+    xcb_sync_create_counter(c, counter, sync_value(0));
+
+    for (int i = 0; i < num_alarms; i++) {
+        uint32_t values[] = {
+            counter,
+            XCB_SYNC_VALUETYPE_ABSOLUTE,
+            0, i + 1,
+            (i & 1) ? XCB_SYNC_TESTTYPE_POSITIVE_TRANSITION :
+                      XCB_SYNC_TESTTYPE_POSITIVE_COMPARISON,
+            0, 0,
+            1,
+        };
+
+        xcb_sync_create_alarm(c, xcb_generate_id(c),
+                              XCB_SYNC_CA_COUNTER | XCB_SYNC_CA_VALUE_TYPE |
+                              XCB_SYNC_CA_VALUE | XCB_SYNC_CA_TEST_TYPE |
+                              XCB_SYNC_CA_DELTA | XCB_SYNC_CA_EVENTS, values);
+    }
+    counter_value(c, xcb_sync_query_counter_unchecked(c, counter));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int step = 1; step <= num_steps; step++) {
+        int64_t value = (int64_t)num_alarms * step / num_steps;
+        xcb_generic_event_t *ev;
+
+        xcb_sync_set_counter(c, counter, sync_value(value));
+        counter_value(c, xcb_sync_query_counter_unchecked(c, counter));
+
+        while ((ev = xcb_poll_for_event(c))) {
+            if ((ev->response_type & 0x7f) ==
+                first_event + XCB_SYNC_ALARM_NOTIFY)
+                fired++;
+            free(ev);
+        }
+
+        if (fired != value) {
+            fprintf(stderr, "Counter at %lld fired %d of %d alarms\n",
+                    (long long)value, fired, num_alarms);
+            exit(1);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("%d alarms on one counter: %d steps in %.3f ms\n",
+           num_alarms, num_steps,
+           (end.tv_sec - start.tv_sec) * 1e3 +
+           (end.tv_nsec - start.tv_nsec) / 1e6);
+}
+
 int main(int argc, char **argv)
 {
     int screen;
@@ -298,6 +360,7 @@ int main(int argc, char **argv)
     test_change_counter_overflow(c);
     test_change_alarm_value(c);
     test_change_alarm_delta(c);
+    test_many_alarms(c, ext->first_event);
 
     xcb_disconnect(c);
     exit(0);
@@ -33,6 +33,8 @@ THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <errno.h>
+#include <sys/stat.h>
 #include <X11/X.h>
 #include <X11/Xos.h>
 #include <X11/Xproto.h>
@@ -41,6 +43,7 @@ THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <X11/extensions/XKM.h>
 
 #include "os/osdep.h"
+#include "os/xsha1.h"
 
 #include "inputstr.h"
 #include "scrnintstr.h"
@@ -54,14 +57,22 @@ THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #if defined(WIN32)
 #define PATHSEPARATOR "\\"
+#define XKBCOMP_NAME "xkbcomp.exe"
+#undef mkdir
+#define mkdir(path,mode) _mkdir(path)
 #else
 #define PATHSEPARATOR "/"
+#define XKBCOMP_NAME "xkbcomp"
 #endif
 
 static unsigned
 LoadXKM(unsigned want, unsigned need, const char *keymap, XkbDescPtr *xkbRtrn);
 
-static void
+/**
+ * Returns FALSE if no output directory could be used and the shared /tmp
+ * is returned instead.
+ */
+static Bool
 OutputDirectory(char *outdir, size_t size)
 {
     const char *directory = NULL;
@@ -93,7 +104,9 @@ OutputDirectory(char *outdir, size_t size)
     if (r < 0 || r >= size) {
         assert(strlen("/tmp/") < size);
         strcpy(outdir, "/tmp/");
+        return FALSE;
     }
+    return TRUE;
 }
 
 /**
@@ -101,15 +114,433 @@ OutputDirectory(char *outdir, size_t size)
  */
 typedef void (*xkbcomp_buffer_callback)(FILE *out, void *userdata);
 
+/**
+ * Compiled keymaps are kept in a directory private to the server's user
+ * below the output directory, named after a hash of everything that
+ * determines xkbcomp's output: the keymap source we feed it, the flags it
+ * is run with, the xkbcomp binary and the content of every component file
+ * the keymap includes.  Loading the same keymap again (server regeneration,
+ * hotplugged keyboards, setxkbmap to a layout used before) then skips
+ * running xkbcomp entirely.  An index file lists the cached keymaps, most
+ * recently used first; those beyond XKM_CACHE_ENTRIES are removed.
+ */
+#define XKM_CACHE_DIR "xkm-cache"
+#define XKM_CACHE_PREFIX "cached-"
+#define XKM_CACHE_INDEX "index"
+#define XKM_CACHE_ENTRIES 32
+#define XKM_CACHE_NAME_LEN (sizeof(XKM_CACHE_PREFIX) - 1 + 40)
+#define XKM_CACHE_MAX_FILES 256
+#define XKM_CACHE_MAX_DEPTH 16
+
+typedef struct {
+    void *ctx;
+    int depth;
+    int nfiles;
+    char *files[XKM_CACHE_MAX_FILES];
+} XkbCacheHashRec, *XkbCacheHashPtr;
+
+static const struct {
+    const char *section;
+    const char *dir;
+} xkb_component_dirs[] = {
+    { "xkb_keycodes", "keycodes" },
+    { "xkb_types", "types" },
+    { "xkb_compat", "compat" },
+    { "xkb_symbols", "symbols" },
+    { "xkb_geometry", "geometry" }
+};
+
+static Bool
+XkbIsCachedKeymap(const char *keymap)
+{
+    return strncmp(keymap, XKM_CACHE_DIR, strlen(XKM_CACHE_DIR)) == 0;
+}
+
+static Bool
+XkbIsCacheEntry(const char *entry)
+{
+    return strlen(entry) == XKM_CACHE_NAME_LEN &&
+        strncmp(entry, XKM_CACHE_PREFIX, strlen(XKM_CACHE_PREFIX)) == 0 &&
+        strspn(entry + strlen(XKM_CACHE_PREFIX), "0123456789abcdef") ==
+        XKM_CACHE_NAME_LEN - strlen(XKM_CACHE_PREFIX);
+}
+
+/**
+ * Find the cache directory, creating it if needed.  Its name relative to
+ * the output directory is returned in sub and its full path in dir, both
+ * ending in a path separator.  The directory must belong to us and be
+ * closed to everybody else, so nobody can plant a keymap for us to load;
+ * the /tmp fallback for the output directory is never used.
+ */
+static Bool
+XkbCacheDirectory(char *sub, size_t subsize, char *dir, size_t size)
+{
+    char outdir[PATH_MAX];
+    int r;
+#ifndef WIN32
+    struct stat st;
+
+    if (!OutputDirectory(outdir, sizeof(outdir)) || outdir[0] != '/')
+        return FALSE;
+    r = snprintf(sub, subsize, "%s-%lu", XKM_CACHE_DIR,
+                 (unsigned long) geteuid());
+#else
+    /* the temporary directory of a Windows user is private to that user */
+    if (!OutputDirectory(outdir, sizeof(outdir)))
+        return FALSE;
+    r = snprintf(sub, subsize, "%s", XKM_CACHE_DIR);
+#endif
+    if (r < 0 || r + strlen(PATHSEPARATOR) >= subsize)
+        return FALSE;
+    r = snprintf(dir, size, "%s%s", outdir, sub);
+    if (r < 0 || r + strlen(PATHSEPARATOR) >= size)
+        return FALSE;
+
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST)
+        return FALSE;
+#ifndef WIN32
+    if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode) ||
+        st.st_uid != geteuid() || (st.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+        return FALSE;
+#endif
+
+    strcat(sub, PATHSEPARATOR);
+    strcat(dir, PATHSEPARATOR);
+    return TRUE;
+}
+
+/**
+ * Check that path is a compiled keymap we have stored in the cache.
+ */
+static Bool
+XkbIsCacheFile(const char *path)
+{
+#ifndef WIN32
+    struct stat st;
+
+    return lstat(path, &st) == 0 && S_ISREG(st.st_mode) &&
+        st.st_uid == geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#else
+    return access(path, R_OK) == 0;
+#endif
+}
+
+/**
+ * Move entry to the front of the cache index in dir and remove the
+ * compiled keymaps of the entries pushed out of it.
+ */
+static void
+XkbCacheUse(const char *dir, const char *entry)
+{
+    char path[PATH_MAX], tmp[PATH_MAX], xkm[PATH_MAX];
+    char line[XKM_CACHE_NAME_LEN + 2];
+    FILE *in, *out;
+    int n = 1;
+
+    if (snprintf(path, sizeof(path), "%s%s", dir,
+                 XKM_CACHE_INDEX) >= sizeof(path) ||
+        snprintf(tmp, sizeof(tmp), "%s%s-%s", dir, XKM_CACHE_INDEX,
+                 display) >= sizeof(tmp))
+        return;
+
+    out = fopen(tmp, "w");
+    if (!out)
+        return;
+    fprintf(out, "%s\n", entry);
+    in = fopen(path, "r");
+    if (in) {
+        while (fgets(line, sizeof(line), in)) {
+            line[strcspn(line, "\n")] = '\0';
+            if (!XkbIsCacheEntry(line) || strcmp(line, entry) == 0)
+                continue;
+            if (n++ < XKM_CACHE_ENTRIES)
+                fprintf(out, "%s\n", line);
+            else if (snprintf(xkm, sizeof(xkm), "%s%s.xkm", dir,
+                              line) < sizeof(xkm))
+                (void) unlink(xkm);
+        }
+        fclose(in);
+    }
+    if (fclose(out) != 0) {
+        (void) unlink(tmp);
+        return;
+    }
+#ifdef WIN32
+    (void) unlink(path);
+#endif
+    if (rename(tmp, path) != 0)
+        (void) unlink(tmp);
+}
+
+/**
+ * Read all of file into a malloc'd buffer.
+ */
+static char *
+XkbReadAll(FILE *file, size_t *lenRtrn)
+{
+    char *text = NULL, *tmp;
+    size_t len = 0, size = 0, n;
+
+    do {
+        if (len == size) {
+            size = size ? 2 * size : 16384;
+            tmp = realloc(text, size);
+            if (!tmp) {
+                free(text);
+                return NULL;
+            }
+            text = tmp;
+        }
+        n = fread(text + len, 1, size - len, file);
+        len += n;
+    } while (n > 0);
+
+    if (ferror(file)) {
+        free(text);
+        return NULL;
+    }
+    *lenRtrn = len;
+    return text;
+}
+
+static Bool
+XkbHashData(XkbCacheHashPtr hash, const void *data, size_t len)
+{
+    if (!x_sha1_update(hash->ctx, (void *) data, len)) {
+        /* x_sha1_update() has already released the context */
+        hash->ctx = NULL;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static Bool
+XkbHashText(XkbCacheHashPtr hash, const char *text, int64_t len)
+{
+    return XkbHashData(hash, &len, sizeof(len)) &&
+        (len <= 0 || XkbHashData(hash, text, len));
+}
+
+static Bool XkbHashFile(XkbCacheHashPtr hash, const char *path,
+                        const char *dir);
+
+/**
+ * Hash the files named by an include expression such as
+ * "pc+us(intl)+inet(evdev)" in the component directory dir.
+ */
+static Bool
+XkbHashIncludes(XkbCacheHashPtr hash, const char *dir, const char *expr)
+{
+    char path[PATH_MAX];
+
+    while (*expr) {
+        size_t len = strcspn(expr, "+|(:");
+
+        if (len > 0) {
+            if (snprintf(path, sizeof(path), "%s/%s/%.*s",
+                         XkbBaseDirectory, dir, (int) len,
+                         expr) >= sizeof(path))
+                return FALSE;
+            if (!XkbHashFile(hash, path, dir))
+                return FALSE;
+        }
+
+        expr += len;
+        if (*expr == '(')
+            expr += strcspn(expr, ")");
+        if (*expr == ':')
+            expr += strcspn(expr, "+|");
+        if (*expr)
+            expr++;
+    }
+    return TRUE;
+}
+
+/**
+ * Hash the files included by the xkb source in text.  The argument of an
+ * include, augment, override or replace statement names files in the
+ * component directory of the section it is in; dir is the directory for
+ * statements before any section keyword, or NULL to skip those.
+ */
+static Bool
+XkbHashSourceIncludes(XkbCacheHashPtr hash, const char *text, size_t len,
+                      const char *dir)
+{
+    const char *p = text, *end = text + len;
+    Bool include = FALSE;
+
+    while (p < end) {
+        if (*p == '#' || (*p == '/' && p + 1 < end && p[1] == '/')) {
+            while (p < end && *p != '\n')
+                p++;
+        }
+        else if (*p == '/' && p + 1 < end && p[1] == '*') {
+            p += 2;
+            while (p + 1 < end && (p[0] != '*' || p[1] != '/'))
+                p++;
+            p += 2;
+        }
+        else if (*p == '"') {
+            const char *s = ++p;
+            char expr[PATH_MAX];
+
+            while (p < end && *p != '"')
+                p += (*p == '\\') ? 2 : 1;
+            if (include && dir && p <= end) {
+                if (p - s >= sizeof(expr))
+                    return FALSE;
+                memcpy(expr, s, p - s);
+                expr[p - s] = '\0';
+                if (!XkbHashIncludes(hash, dir, expr))
+                    return FALSE;
+            }
+            include = FALSE;
+            p++;
+        }
+        else if (isalpha((unsigned char) *p) || *p == '_') {
+            const char *s = p;
+            size_t n;
+            int i;
+
+            while (p < end && (isalnum((unsigned char) *p) || *p == '_'))
+                p++;
+            n = p - s;
+            include = (n == 7 && (strncasecmp(s, "include", n) == 0 ||
+                                  strncasecmp(s, "augment", n) == 0 ||
+                                  strncasecmp(s, "replace", n) == 0)) ||
+                (n == 8 && strncasecmp(s, "override", n) == 0);
+            for (i = 0; i < ARRAY_SIZE(xkb_component_dirs); i++) {
+                size_t l = strlen(xkb_component_dirs[i].section);
+
+                if (n >= l &&
+                    strncasecmp(s, xkb_component_dirs[i].section, l) == 0)
+                    dir = xkb_component_dirs[i].dir;
+            }
+        }
+        else {
+            if (!isspace((unsigned char) *p))
+                include = FALSE;
+            p++;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * Hash the name and content of the file at path and, if dir is not NULL,
+ * of the files it includes from that component directory.  Every file is
+ * hashed once.  A missing file is hashed as such, so creating it changes
+ * the hash as well.
+ */
+static Bool
+XkbHashFile(XkbCacheHashPtr hash, const char *path, const char *dir)
+{
+    FILE *file;
+    char *text;
+    size_t len;
+    Bool ret;
+    int i;
+
+    for (i = 0; i < hash->nfiles; i++) {
+        if (strcmp(hash->files[i], path) == 0)
+            return TRUE;
+    }
+    if (hash->nfiles == XKM_CACHE_MAX_FILES ||
+        hash->depth == XKM_CACHE_MAX_DEPTH)
+        return FALSE;
+    hash->files[hash->nfiles] = strdup(path);
+    if (!hash->files[hash->nfiles])
+        return FALSE;
+    hash->nfiles++;
+
+    if (!XkbHashData(hash, path, strlen(path) + 1))
+        return FALSE;
+
+    file = fopen(path, "rb");
+    if (!file)
+        return XkbHashText(hash, NULL, -1);
+    text = XkbReadAll(file, &len);
+    fclose(file);
+    if (!text)
+        return FALSE;
+
+    hash->depth++;
+    ret = XkbHashText(hash, text, len) &&
+        (!dir || XkbHashSourceIncludes(hash, text, len, dir));
+    hash->depth--;
+    free(text);
+    return ret;
+}
+
+/**
+ * Compute the cache entry name for the xkbcomp input in file, compiled
+ * with cmdflags by the xkbcomp binary at path xkbcomp.  Returns FALSE if no
+ * name could be computed, in which case the keymap is compiled without
+ * being cached.
+ */
+static Bool
+XkbCachedKeymapName(FILE *file, const char *cmdflags, const char *xkbcomp,
+                    char *name, size_t size)
+{
+    static const char hex[] = "0123456789abcdef";
+    XkbCacheHashRec hash = { 0 };
+    unsigned char sha1[20];
+    char *text;
+    size_t len;
+    Bool ok;
+    int i;
+
+    if (XkbBaseDirectory == NULL || size < XKM_CACHE_NAME_LEN + 1)
+        return FALSE;
+
+    text = XkbReadAll(file, &len);
+    if (!text)
+        return FALSE;
+
+    hash.ctx = x_sha1_init();
+    ok = hash.ctx &&
+        XkbHashData(&hash, cmdflags, strlen(cmdflags) + 1) &&
+        XkbHashFile(&hash, xkbcomp, NULL) &&
+        XkbHashText(&hash, text, len) &&
+        XkbHashSourceIncludes(&hash, text, len, NULL);
+
+    free(text);
+    for (i = 0; i < hash.nfiles; i++)
+        free(hash.files[i]);
+
+    if (!ok) {
+        if (hash.ctx)
+            x_sha1_final(hash.ctx, sha1);
+        return FALSE;
+    }
+    if (!x_sha1_final(hash.ctx, sha1))
+        return FALSE;
+
+    strcpy(name, XKM_CACHE_PREFIX);
+    name += strlen(XKM_CACHE_PREFIX);
+    for (i = 0; i < sizeof(sha1); i++) {
+        *name++ = hex[sha1[i] >> 4];
+        *name++ = hex[sha1[i] & 0xf];
+    }
+    *name = '\0';
+    return TRUE;
+}
+
 /**
  * Start xkbcomp, let the callback write into xkbcomp's stdin. When done,
- * return a strdup'd copy of the file name we've written to.
+ * return a strdup'd copy of the file name we've written to.  If an
+ * identical keymap has been compiled before, return the name of the
+ * cached copy instead.
  */
 static char *
 RunXkbComp(xkbcomp_buffer_callback callback, void *userdata)
 {
-    FILE *out;
+    FILE *out, *in;
     char *buf = NULL, keymap[PATH_MAX], xkm_output_dir[PATH_MAX];
+    char cached[PATH_MAX], cmdflags[PATH_MAX], xkbcomp[PATH_MAX];
+    char cachesub[PATH_MAX], cachedir[PATH_MAX], cachename[PATH_MAX];
+    Bool cache;
+    CARD32 start = GetTimeInMillis();
 
     const char *emptystring = "";
     char *xkbbasedirflag = NULL;
@@ -151,6 +582,57 @@ RunXkbComp(xkbcomp_buffer_callback callback, void *userdata)
         }
     }
 
+    snprintf(cmdflags, sizeof(cmdflags), "%s%s -w %d %s",
+             xkbbindir, xkbbindirsep,
+             ((xkbDebugFlags < 2) ? 1 :
+              ((xkbDebugFlags > 10) ? 10 : (int) xkbDebugFlags)),
+             xkbbasedirflag ? xkbbasedirflag : "");
+
+    /* Render the input first so it can be hashed */
+#ifndef WIN32
+    in = tmpfile();
+#else
+    in = fopen(tmpname, "w+");
+#endif
+    if (!in) {
+        free(xkbbasedirflag);
+#ifndef WIN32
+        LogMessage(X_ERROR, "XKB: Could not create xkbcomp input file\n");
+#else
+        LogMessage(X_ERROR, "Could not open file %s\n", tmpname);
+#endif
+        return NULL;
+    }
+    (*callback)(in, userdata);
+    rewind(in);
+
+    /* without a bin directory xkbcomp is found in PATH and can't be
+     * hashed */
+    cache = xkbbindir[0] != '\0' &&
+        snprintf(xkbcomp, sizeof(xkbcomp), "%s%s%s", xkbbindir,
+                 xkbbindirsep, XKBCOMP_NAME) < sizeof(xkbcomp) &&
+        XkbCacheDirectory(cachesub, sizeof(cachesub),
+                          cachedir, sizeof(cachedir)) &&
+        XkbCachedKeymapName(in, cmdflags, xkbcomp, cached, sizeof(cached)) &&
+        snprintf(cachename, sizeof(cachename), "%s%s", cachesub,
+                 cached) < sizeof(cachename);
+    if (cache) {
+        char path[PATH_MAX];
+
+        if (snprintf(path, sizeof(path), "%s%s.xkm", cachedir,
+                     cached) < sizeof(path) && XkbIsCacheFile(path)) {
+            DebugF("[xkb] using cached keymap %s\n", path);
+            fclose(in);
+#ifdef WIN32
+            unlink(tmpname);
+#endif
+            free(xkbbasedirflag);
+            XkbCacheUse(cachedir, cached);
+            return xnfstrdup(cachename);
+        }
+    }
+    rewind(in);
+
     if (asprintf(&buf,
                  "\"%s%sxkbcomp\" -w %d %s -xkm \"%s\" "
                  "-em1 %s -emp %s -eml %s \"%s%s.xkm\"",
@@ -167,18 +649,29 @@ RunXkbComp(xkbcomp_buffer_callback callback, void *userdata)
     if (!buf) {
         LogMessage(X_ERROR,
                    "XKB: Could not invoke xkbcomp: not enough memory\n");
+        fclose(in);
+#ifdef WIN32
+        unlink(tmpname);
+#endif
         return NULL;
     }
 
 #ifndef WIN32
     out = Popen(buf, "w");
 #else
-    out = fopen(tmpname, "w");
+    out = in;
 #endif
 
     if (out != NULL) {
+#ifndef WIN32
         /* Now write to xkbcomp */
-        (*callback)(out, userdata);
+        char data[4096];
+        size_t n;
+
+        while ((n = fread(data, 1, sizeof(data), in)) > 0)
+            fwrite(data, 1, n, out);
+        fclose(in);
+#endif
 
 #ifndef WIN32
         if (Pclose(out) == 0)
@@ -192,6 +685,27 @@ RunXkbComp(xkbcomp_buffer_callback callback, void *userdata)
 #ifdef WIN32
             unlink(tmpname);
 #endif
+            DebugF("[xkb] compiled keymap in %u ms\n",
+                   (unsigned int) (GetTimeInMillis() - start));
+
+            if (cache) {
+                char from[PATH_MAX], to[PATH_MAX];
+
+                /* keep the result for next time; on any failure the
+                 * keymap is just used uncached */
+                if (snprintf(from, sizeof(from), "%s%s.xkm", xkm_output_dir,
+                             keymap) < sizeof(from) &&
+                    snprintf(to, sizeof(to), "%s%s.xkm", cachedir,
+                             cached) < sizeof(to)) {
+#ifdef WIN32
+                    (void) unlink(to);
+#endif
+                    if (rename(from, to) == 0) {
+                        XkbCacheUse(cachedir, cached);
+                        return xnfstrdup(cachename);
+                    }
+                }
+            }
             return xnfstrdup(keymap);
         }
         else {
@@ -204,6 +718,7 @@ RunXkbComp(xkbcomp_buffer_callback callback, void *userdata)
 #endif
     }
     else {
+        fclose(in);
 #ifndef WIN32
         LogMessage(X_ERROR, "XKB: Could not invoke xkbcomp\n");
 #else
@@ -364,7 +879,8 @@ LoadXKM(unsigned want, unsigned need, const char *keymap, XkbDescPtr *xkbRtrn)
                (*xkbRtrn)->defined);
     }
     fclose(file);
-    (void) unlink(fileName);
+    if (!XkbIsCachedKeymap(keymap))
+        (void) unlink(fileName);
     return (need | want) & (~missing);
 }
 